@@ -32,9 +32,119 @@
 #endif
 /// FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE. Helper to identify if any of these profiles is used.
 #define FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE (FFXM_FSR2_OPTION_SHADER_OPT_BALANCED || FFXM_FSR2_OPTION_SHADER_OPT_PERFORMANCE)
+/// FFXM_FSR2_OPTION_COMPACT_HISTORY. Quality only. If defined, the color history is stored as R11G11B10 with the temporal reactive factor in a separate RT.
+#ifndef FFXM_FSR2_OPTION_COMPACT_HISTORY
+#define FFXM_FSR2_OPTION_COMPACT_HISTORY 0
+#endif
+
+/// FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY. If defined, the lock status and separate temporal reactive histories are stored at render resolution.
+#ifndef FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
+#define FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY 0
+#endif
+
+/// FFXM_FSR2_OPTION_LUMA_MOMENTS. Quality only. If defined, the luma history stores a running luma mean and standard deviation instead of the last 4 frames of luma.
+#ifndef FFXM_FSR2_OPTION_LUMA_MOMENTS
+#define FFXM_FSR2_OPTION_LUMA_MOMENTS 0
+#endif
+#if FFXM_FSR2_OPTION_LUMA_MOMENTS
+#define FFXM_FSR2_LUMA_HISTORY_TYPE FfxFloat32x2
+#else
+#define FFXM_FSR2_LUMA_HISTORY_TYPE FfxFloat32x4
+#endif
+
+/// FFXM_FSR2_OPTION_REPROJECT_LANCZOS_BILINEAR. Quality only. If defined, history reprojection uses Lanczos2 weights with 9 bilinear fetches instead of the default kernel.
+#ifndef FFXM_FSR2_OPTION_REPROJECT_LANCZOS_BILINEAR
+#define FFXM_FSR2_OPTION_REPROJECT_LANCZOS_BILINEAR 0
+#endif
+
+/// FFXM_FSR2_OPTION_UPSCALE_RATIO. 0 reads the downscale factor from the constant buffer. 1 to 4 fix it at compile time
+/// for 1.5x, 1.7x, 2x and 3x upscaling, so the source position and kernel size arithmetic that depends on it folds.
+#ifndef FFXM_FSR2_OPTION_UPSCALE_RATIO
+#define FFXM_FSR2_OPTION_UPSCALE_RATIO 0
+#endif
+/// FFXM_FSR2_UPSCALE_RATIO_PERIOD is the number of output pixels after which the output to input pixel mapping repeats.
+#if FFXM_FSR2_OPTION_UPSCALE_RATIO == 1
+#define FFXM_FSR2_FIXED_DOWNSCALE_FACTOR (1.0f / 1.5f)
+#define FFXM_FSR2_UPSCALE_RATIO_PERIOD 3
+#elif FFXM_FSR2_OPTION_UPSCALE_RATIO == 2
+#define FFXM_FSR2_FIXED_DOWNSCALE_FACTOR (1.0f / 1.7f)
+#define FFXM_FSR2_UPSCALE_RATIO_PERIOD 17
+#elif FFXM_FSR2_OPTION_UPSCALE_RATIO == 3
+#define FFXM_FSR2_FIXED_DOWNSCALE_FACTOR (1.0f / 2.0f)
+#define FFXM_FSR2_UPSCALE_RATIO_PERIOD 2
+#elif FFXM_FSR2_OPTION_UPSCALE_RATIO == 4
+#define FFXM_FSR2_FIXED_DOWNSCALE_FACTOR (1.0f / 3.0f)
+#define FFXM_FSR2_UPSCALE_RATIO_PERIOD 3
+#endif
+
+/// FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE. Requires FFXM_FSR2_OPTION_UPSCALE_RATIO. If defined, the upsample Lanczos weights of
+/// pixels with the widest kernel are read from a table built for each jitter phase instead of being evaluated per tap.
+#ifndef FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE
+#define FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE 0
+#endif
+
+/// FFXM_FSR2_OPTION_LANCZOS_LUT. If defined, the upsample and Lanczos reprojection weights are read from a lookup texture of
+/// Lanczos2 indexed by the squared distance, instead of being evaluated with the FSR1 approximation.
+#ifndef FFXM_FSR2_OPTION_LANCZOS_LUT
+#define FFXM_FSR2_OPTION_LANCZOS_LUT 0
+#endif
+/// Number of texels in the Lanczos lookup texture. Must match ARM_ASR_LANCZOS_LUT_WIDTH.
+#define FFXM_FSR2_LANCZOS_LUT_WIDTH 128
+
+/// FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS. Not for Ultra Performance. If defined, the prepared input colour and the lock luma
+/// are recomputed from the input colour and exposure where they are read, instead of being stored by Depth Clip and Reconstruct
+/// Previous Depth. Depth Clip then only stores the depth clip factor, in an R8 target.
+#ifndef FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+#define FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS 0
+#endif
+
+/// FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID. Only when the exposure comes from the engine. If defined, the luminance pyramid is
+/// only downsampled down to the shading change mip, which is the only mip stored, so SPD never reaches its last workgroup
+/// reduction and needs no global atomic.
+#ifndef FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID
+#define FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID 0
+#endif
+
+/// FFXM_FSR2_OPTION_FUSED_LUMA_MIP. Requires FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID. If defined, Depth Clip writes the first
+/// (half resolution) level of the luminance pyramid from its 2x2 pixel quads, and the pyramid pass downsamples from it instead
+/// of reading the input colour again.
+#ifndef FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+#define FFXM_FSR2_OPTION_FUSED_LUMA_MIP 0
+#endif
+
+/// FFXM_FSR2_OPTION_GATHER_NEAREST_DEPTH. If defined, Reconstruct Previous Depth fetches the 3x3 depth neighborhood it dilates
+/// from with four point gathers instead of nine loads.
+#ifndef FFXM_FSR2_OPTION_GATHER_NEAREST_DEPTH
+#define FFXM_FSR2_OPTION_GATHER_NEAREST_DEPTH 0
+#endif
+
+/// FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH. If defined, the reconstructed previous depth keeps a frame epoch in its top 8 bits,
+/// so texels that weren't written this frame read as cleared and the texture doesn't need clearing every frame.
+#ifndef FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH
+#define FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH 0
+#endif
+
+/// FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH. Only for Performance and Ultra Performance. If defined, the previous depth is
+/// reconstructed into a half render resolution texture, each texel keeping the nearest depth scattered into its 2x2 pixels.
+#ifndef FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH
+#define FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH 0
+#endif
+
+/// FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD. Compute passes only. If defined, Depth Clip and Lock stage each thread group's
+/// tile and its one pixel halo in groupshared memory once, and read their 3x3 neighborhoods from it instead of fetching them
+/// per pixel. The pass must define FFXM_FSR2_THREAD_GROUP_WIDTH and FFXM_FSR2_THREAD_GROUP_HEIGHT before the includes.
+#ifndef FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+#define FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD 0
+#endif
+
+/// FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD. Pixel shader passes only, requires quad wave operations. If defined, each pixel of a
+/// 2x2 quad gathers a quarter of the quad's 3x3 neighborhoods in Depth Clip and reads the rest from the other pixels with QuadReadAcross*.
+#ifndef FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD
+#define FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD 0
+#endif
 
-/// Both Balanced/Performance. Keep the temporal reactive as a separate RT to improve bandwidth of color history buffer.
-#define FFXM_SHADER_QUALITY_OPT_SEPARATE_TEMPORAL_REACTIVE FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE
+/// Both Balanced/Performance, and Quality with a compact history. Keep the temporal reactive as a separate RT to improve bandwidth of color history buffer.
+#define FFXM_SHADER_QUALITY_OPT_SEPARATE_TEMPORAL_REACTIVE (FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE || FFXM_FSR2_OPTION_COMPACT_HISTORY)
 /// Both Balanced/Performance. Disable deringing when doing the color reprojection with the history
 #define FFXM_SHADER_QUALITY_OPT_DISABLE_DERINGING FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE
 /// Balanced, Performance and Ultra Performance all disable the Luma stability factor.
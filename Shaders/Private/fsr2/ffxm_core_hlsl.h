@@ -50,6 +50,11 @@
 /// @ingroup HLSLCore
 #define FFXM_UNROLL [unroll]
 
+/// A define for abstracting dynamic branching hints between shading languages.
+///
+/// @ingroup HLSLCore
+#define FFXM_BRANCH [branch]
+
 /// A define for abstracting a 'greater than' comparison operator between two types.
 ///
 /// @ingroup HLSLCore
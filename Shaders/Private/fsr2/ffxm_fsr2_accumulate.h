@@ -36,7 +36,7 @@ struct AccumulateOutputs
     FfxFloat32 fTemporalReactive;
 #endif
     FfxFloat32x2 fLockStatus;
-    FfxFloat32x4 fLumaHistory;
+    FFXM_FSR2_LUMA_HISTORY_TYPE fLumaHistory;
 #endif
 #if (FFXM_FSR2_OPTION_APPLY_SHARPENING == 0)
     FfxFloat32x3 fColor;
@@ -178,10 +178,17 @@ FfxFloat32 ComputeLumaInstabilityFactor(const AccumulationPassCommonParams param
 #endif
 {
     const FfxFloat32 fUnormThreshold = 1.0f / 255.0f;
+#if FFXM_FSR2_OPTION_LUMA_MOMENTS
+    // Weight of the current frame in the running moments, roughly the 4 frame window of the luma ring.
+    const FfxFloat32 fMomentsBlend = 0.25f;
+    const FfxInt32 LUMA_MEAN = 0;
+    const FfxInt32 LUMA_STDDEV = 1;
+#else
     const FfxInt32 N_MINUS_1 = 0;
     const FfxInt32 N_MINUS_2 = 1;
     const FfxInt32 N_MINUS_3 = 2;
     const FfxInt32 N_MINUS_4 = 3;
+#endif
 
     FfxFloat32 fCurrentFrameLuma = clippingBox.boxCenter.x;
 
@@ -192,6 +199,35 @@ FfxFloat32 ComputeLumaInstabilityFactor(const AccumulationPassCommonParams param
     fCurrentFrameLuma = round(fCurrentFrameLuma * 255.0f) / 255.0f;
 
     const FfxBoolean bSampleLumaHistory = (ffxMax(ffxMax(params.fDepthClipFactor, params.fAccumulationMask), fLuminanceDiff) < 0.1f) && (params.bIsNewSample == false);
+
+#if FFXM_FSR2_OPTION_LUMA_MOMENTS
+    // A disoccluded or changed sample restarts the moments at the current luma with no variance.
+    FfxFloat32x2 fLumaMoments = bSampleLumaHistory ? FfxFloat32x2(SampleLumaMoments(params.fReprojectedHrUv)) : FfxFloat32x2(fCurrentFrameLuma, 0.0f);
+
+    FfxFloat32 fLumaInstability = 0.0f;
+    const FfxFloat32 fDiffFromMean = fCurrentFrameLuma - fLumaMoments[LUMA_MEAN];
+    const FfxFloat32 fStdDev = fLumaMoments[LUMA_STDDEV];
+
+    // Flickering luma keeps a standard deviation that its samples stay within, while a steady or
+    // monotonically changing luma either has no variance or moves away from the mean.
+    if (fStdDev >= fUnormThreshold && abs(fDiffFromMean) <= 2.0f * fStdDev) {
+        const FfxFloat32 fBoxSize       = clippingBox.boxVec.x;
+        const FfxFloat32 fBoxSizeFactor = ffxPow(ffxSaturate(fBoxSize / 0.1f), 6.0f);
+
+        fLumaInstability = FfxFloat32(fBoxSizeFactor > fUnormThreshold);
+
+        fLumaInstability *= 1.0f - ffxMax(params.fAccumulationMask, ffxPow(fThisFrameReactiveFactor, 1.0f / 6.0f));
+    }
+
+    // Update running mean and variance
+    const FfxFloat32 fVariance = (1.0f - fMomentsBlend) * (fStdDev * fStdDev + fMomentsBlend * fDiffFromMean * fDiffFromMean);
+    fLumaMoments[LUMA_MEAN] = fLumaMoments[LUMA_MEAN] + fMomentsBlend * fDiffFromMean;
+    fLumaMoments[LUMA_STDDEV] = sqrt(fVariance);
+
+    result.fLumaHistory = fLumaMoments;
+
+    return fLumaInstability;
+#else
     FfxFloat32x4 fCurrentFrameLumaHistory = bSampleLumaHistory ? SampleLumaHistory(params.fReprojectedHrUv) : FFXM_BROADCAST_FLOAT32X4(0.0f);
 
     FfxFloat32 fLumaInstability = 0.0f;
@@ -229,6 +265,7 @@ FfxFloat32 ComputeLumaInstabilityFactor(const AccumulationPassCommonParams param
     result.fLumaHistory = fCurrentFrameLumaHistory;
 
     return fLumaInstability * FfxFloat32(fCurrentFrameLumaHistory[N_MINUS_4] != 0);
+#endif
 }
 #endif
 
@@ -36,14 +36,15 @@
 #define FSR2_BIND_SRV_INTERNAL_UPSCALED                      3
 #define FSR2_BIND_SRV_LOCK_STATUS                            4
 
-#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE || FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
 #define FSR2_BIND_SRV_INPUT_COLOR                            5
 #else
 #define FSR2_BIND_SRV_PREPARED_INPUT_COLOR                   5
 #endif
 
+#if FFXM_FSR2_OPTION_LANCZOS_LUT
 #define FSR2_BIND_SRV_LANCZOS_LUT                            6
-#define FSR2_BIND_SRV_UPSCALE_MAXIMUM_BIAS_LUT               7
+#endif
 #define FSR2_BIND_SRV_SCENE_LUMINANCE_MIPS                   8
 #define FSR2_BIND_SRV_AUTO_EXPOSURE                          9
 
@@ -55,6 +56,22 @@
 #define FSR2_BIND_SRV_NEW_LOCKS                              12
 #endif
 
+#if FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE
+#define FSR2_BIND_SRV_UPSAMPLE_WEIGHTS                       15
+#endif
+
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+#define FSR2_BIND_SRV_DEPTH_CLIP                             16
+#endif
+
+// Pixel shader UAV slots follow the render targets on D3D11, so keep them clear of SV_TARGET0-3.
+#if FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
+#define FSR2_BIND_UAV_RENDER_RES_LOCK_STATUS                 4
+#if FFXM_SHADER_QUALITY_OPT_SEPARATE_TEMPORAL_REACTIVE
+#define FSR2_BIND_UAV_RENDER_RES_TEMPORAL_REACTIVE           5
+#endif
+#endif
+
 #define FSR2_BIND_CB_FSR2                                    0
 
 #include "ffxm_fsr2_callbacks_hlsl.h"
@@ -72,19 +89,42 @@ struct VertexOut
 
 struct AccumulateOutputsFS
 {
-#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#if FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
+    // Lock status and temporal reactive are written to render resolution UAVs instead.
+#if !FFXM_SHADER_QUALITY_OPT_SEPARATE_TEMPORAL_REACTIVE && !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+    FfxFloat32x4 fColorAndWeight    : SV_TARGET0;
+#else
+    FfxFloat32x3 fUpscaledColor     : SV_TARGET0;
+#endif
+#if !FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE && !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+    FFXM_FSR2_LUMA_HISTORY_TYPE fLumaHistory : SV_TARGET1;
+#if FFXM_FSR2_OPTION_APPLY_SHARPENING == 0
+    FfxFloat32x3 fColor             : SV_TARGET2;
+#endif
+#elif FFXM_FSR2_OPTION_APPLY_SHARPENING == 0
+    FfxFloat32x3 fColor             : SV_TARGET1;
+#endif
+#elif FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
     FfxFloat32x3 fUpscaledColor    : SV_TARGET0;
     FfxFloat32x2 fLockStatus        : SV_TARGET1;
 #if FFXM_FSR2_OPTION_APPLY_SHARPENING == 0
     FfxFloat32x3 fColor             : SV_TARGET2;
 #endif
-#elif !FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE
+#elif !FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE && !FFXM_FSR2_OPTION_COMPACT_HISTORY
     FfxFloat32x4 fColorAndWeight    : SV_TARGET0;
     FfxFloat32x2 fLockStatus        : SV_TARGET1;
-    FfxFloat32x4 fLumaHistory       : SV_TARGET2;
+    FFXM_FSR2_LUMA_HISTORY_TYPE fLumaHistory : SV_TARGET2;
 #if FFXM_FSR2_OPTION_APPLY_SHARPENING == 0
     FfxFloat32x3 fColor             : SV_TARGET3;
 #endif
+#elif !FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE // Quality with compact history
+    FfxFloat32x3 fUpscaledColor     : SV_TARGET0;
+    FfxFloat32 fTemporalReactive    : SV_TARGET1;
+    FfxFloat32x2 fLockStatus        : SV_TARGET2;
+    FFXM_FSR2_LUMA_HISTORY_TYPE fLumaHistory : SV_TARGET3;
+#if FFXM_FSR2_OPTION_APPLY_SHARPENING == 0
+    FfxFloat32x3 fColor             : SV_TARGET4;
+#endif
 #else // FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE
     FfxFloat32x3 fUpscaledColor     : SV_TARGET0;
     FfxFloat32 fTemporalReactive    : SV_TARGET1;
@@ -95,21 +135,51 @@ struct AccumulateOutputsFS
 #endif
 };
 
+#if FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
+// Every render pixel is written by the display pixel that contains its centre, so each one has exactly one writer.
+void StoreRenderResAuxHistory(FfxInt32x2 iPxHrPos, AccumulateOutputs result)
+{
+    const FfxInt32x2 iPxLrPos = FfxInt32x2((FfxFloat32x2(iPxHrPos) + 0.5f) * FfxFloat32x2(RenderSize()) / FfxFloat32x2(DisplaySize()));
+    const FfxInt32x2 iPxOwnerHrPos = FfxInt32x2((FfxFloat32x2(iPxLrPos) + 0.5f) * FfxFloat32x2(DisplaySize()) / FfxFloat32x2(RenderSize()));
+
+    if (all(iPxOwnerHrPos == iPxHrPos))
+    {
+        StoreRenderResLockStatus(iPxLrPos, result.fLockStatus);
+#if FFXM_SHADER_QUALITY_OPT_SEPARATE_TEMPORAL_REACTIVE
+        StoreRenderResTemporalReactive(iPxLrPos, result.fTemporalReactive);
+#endif
+    }
+}
+#endif
+
 AccumulateOutputsFS main(float4 SvPosition : SV_POSITION)
 {
     uint2 uPixelCoord = uint2(SvPosition.xy);
     AccumulateOutputs result = Accumulate(uPixelCoord);
     AccumulateOutputsFS output = (AccumulateOutputsFS)0;
+#if FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
+    StoreRenderResAuxHistory(FfxInt32x2(uPixelCoord), result);
+#endif
 #if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
     output.fUpscaledColor = result.fColorAndWeight.xyz;
-#elif !FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE
+#elif !FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE && !FFXM_FSR2_OPTION_COMPACT_HISTORY
     output.fColorAndWeight = result.fColorAndWeight;
     output.fLumaHistory = result.fLumaHistory;
+#elif !FFXM_SHADER_QUALITY_BALANCED_OR_PERFORMANCE
+    output.fUpscaledColor = result.fUpscaledColor;
+#if !FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
+    output.fTemporalReactive = result.fTemporalReactive;
+#endif
+    output.fLumaHistory = result.fLumaHistory;
 #else
     output.fUpscaledColor = result.fUpscaledColor;
+#if !FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
     output.fTemporalReactive = result.fTemporalReactive;
 #endif
+#endif
+#if !FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY
     output.fLockStatus = result.fLockStatus;
+#endif
 #if FFXM_FSR2_OPTION_APPLY_SHARPENING == 0
     output.fColor = result.fColor;
 #endif
@@ -80,6 +80,9 @@
         FfxFloat32    fDeltaTime;
         FfxFloat32    fDynamicResChangeFactor;
         FfxFloat32    fViewSpaceToMetersFactor;
+        FfxUInt32     uReconstructedDepthEpoch;
+        FfxUInt32     uGroupSwizzleWidth;
+        FfxUInt32     uJitterPhaseIndex;
     };
 
 #define FFXM_FSR2_CONSTANT_BUFFER_1_SIZE (sizeof(cbArmASR) / 4)  // Number of 32-bit values. This must be kept in sync with the cbArmASR size.
@@ -137,7 +140,11 @@ FfxFloat32x2 MotionVectorScale()
 
 FfxFloat32x2 DownscaleFactor()
 {
+#if FFXM_FSR2_OPTION_UPSCALE_RATIO
+    return FFXM_BROADCAST_FLOAT32X2(FFXM_FSR2_FIXED_DOWNSCALE_FACTOR);
+#else
     return fDownscaleFactor;
+#endif
 }
 
 FfxFloat32x2 MotionVectorJitterCancellation()
@@ -184,6 +191,21 @@ FfxFloat32 ViewSpaceToMetersFactor()
 {
     return fViewSpaceToMetersFactor;
 }
+
+FfxUInt32 ReconstructedDepthEpoch()
+{
+    return uReconstructedDepthEpoch;
+}
+
+FfxUInt32 GroupSwizzleWidth()
+{
+    return uGroupSwizzleWidth;
+}
+
+FfxUInt32 JitterPhaseIndex()
+{
+    return uJitterPhaseIndex;
+}
 #endif // #if defined(FSR2_BIND_CB_FSR2)
 
 #define FFXM_FSR2_ROOTSIG_STRINGIFY(p) FFXM_FSR2_ROOTSIG_STR(p)
@@ -204,7 +226,7 @@ FfxFloat32 ViewSpaceToMetersFactor()
                                                       "comparisonFunc = COMPARISON_NEVER, " \
                                                       "borderColor = STATIC_BORDER_COLOR_TRANSPARENT_BLACK)" )]
 
-#define FFXM_FSR2_CONSTANT_BUFFER_2_SIZE 6  // Number of 32-bit values. This must be kept in sync with max( cbArmASRRCAS , cbArmASRSPD) size.
+#define FFXM_FSR2_CONSTANT_BUFFER_2_SIZE 8  // Number of 32-bit values. This must be kept in sync with max( cbArmASRRCAS , cbArmASRSPD) size.
 
 #define FFXM_FSR2_CB2_ROOTSIG [RootSignature( "DescriptorTable(UAV(u0, numDescriptors = " FFXM_FSR2_ROOTSIG_STRINGIFY(FFXM_FSR2_RESOURCE_IDENTIFIER_COUNT) ")), " \
                                     "DescriptorTable(SRV(t0, numDescriptors = " FFXM_FSR2_ROOTSIG_STRINGIFY(FFXM_FSR2_RESOURCE_IDENTIFIER_COUNT) ")), " \
@@ -234,12 +256,19 @@ FfxFloat32 ViewSpaceToMetersFactor()
 cbuffer cbArmASRRCAS : FFXM_FSR2_DECLARE_CB(FSR2_BIND_CB_RCAS)
 {
     FfxUInt32x4 rcasConfig;
+    FfxFloat32x4 rcasUpsampleConfig;
 };
 
 FfxUInt32x4 RCASConfig()
 {
     return rcasConfig;
 }
+
+// xy: reciprocal of the output size, z: 1 when sharpening is applied after the upsample.
+FfxFloat32x4 RCASUpsampleConfig()
+{
+    return rcasUpsampleConfig;
+}
 #endif // #if defined(FSR2_BIND_CB_RCAS)
 
 
@@ -325,11 +354,9 @@ SamplerState s_LinearClamp : register(s1);
     #if defined FSR2_BIND_SRV_AUTO_EXPOSURE
         Texture2D<FfxFloat32x2> r_auto_exposure : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_AUTO_EXPOSURE);
     #endif
-    #if defined FSR2_BIND_SRV_REACTIVE_MASK
-        Texture2D<FfxFloat32> r_reactive_mask : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_REACTIVE_MASK);
-    #endif
-    #if defined FSR2_BIND_SRV_TRANSPARENCY_AND_COMPOSITION_MASK
-        Texture2D<FfxFloat32> r_transparency_and_composition_mask : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_TRANSPARENCY_AND_COMPOSITION_MASK);
+    // Reactive mask in R, transparency and composition mask in G.
+    #if defined FSR2_BIND_SRV_REACTIVE_AND_COMPOSITION_MASKS
+        Texture2D<FfxFloat32x2> r_reactive_and_composition_masks : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_REACTIVE_AND_COMPOSITION_MASKS);
     #endif
     #if defined FSR2_BIND_SRV_RECONSTRUCTED_PREV_NEAREST_DEPTH
         Texture2D<FfxUInt32> r_reconstructed_previous_nearest_depth : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_RECONSTRUCTED_PREV_NEAREST_DEPTH);
@@ -358,8 +385,17 @@ SamplerState s_LinearClamp : register(s1);
     #if defined FSR2_BIND_SRV_PREPARED_INPUT_COLOR
         Texture2D<FfxFloat32x4> r_prepared_input_color : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_PREPARED_INPUT_COLOR);
     #endif
+    #if defined FSR2_BIND_SRV_DEPTH_CLIP
+        Texture2D<unorm FfxFloat32> r_depth_clip : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_DEPTH_CLIP);
+    #endif
+    #if defined FSR2_BIND_SRV_LUMA_MIP_0
+        Texture2D<FfxFloat32> r_luma_mip_0 : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_LUMA_MIP_0);
+    #endif
+    #if defined FSR2_BIND_SRV_UPSAMPLE_WEIGHTS
+        Buffer<FfxFloat32x4> r_upsample_weights : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_UPSAMPLE_WEIGHTS);
+    #endif
     #if defined FSR2_BIND_SRV_LUMA_HISTORY
-        Texture2D<unorm FfxFloat32x4> r_luma_history : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_LUMA_HISTORY);
+        Texture2D<unorm FFXM_FSR2_LUMA_HISTORY_TYPE> r_luma_history : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_LUMA_HISTORY);
     #endif
     #if defined FSR2_BIND_SRV_RCAS_INPUT
         Texture2D<FfxFloat32x4> r_rcas_input : FFXM_FSR2_DECLARE_SRV(FSR2_BIND_SRV_RCAS_INPUT);
@@ -404,6 +440,12 @@ SamplerState s_LinearClamp : register(s1);
     #if defined FSR2_BIND_UAV_LOCK_STATUS
         RWTexture2D<unorm FfxFloat32x2> rw_lock_status : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_LOCK_STATUS);
     #endif
+    #if defined FSR2_BIND_UAV_RENDER_RES_LOCK_STATUS
+        RWTexture2D<FfxFloat32x2> rw_render_res_lock_status : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_RENDER_RES_LOCK_STATUS);
+    #endif
+    #if defined FSR2_BIND_UAV_RENDER_RES_TEMPORAL_REACTIVE
+        RWTexture2D<FfxFloat32> rw_render_res_temporal_reactive : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_RENDER_RES_TEMPORAL_REACTIVE);
+    #endif
     #if defined FSR2_BIND_UAV_LOCK_INPUT_LUMA
         RWTexture2D<FfxFloat32> rw_lock_input_luma : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_LOCK_INPUT_LUMA);
     #endif
@@ -425,9 +467,15 @@ SamplerState s_LinearClamp : register(s1);
     #if defined FSR2_BIND_UAV_EXPOSURE_MIP_5
         globallycoherent RWTexture2D<FfxFloat32> rw_img_mip_5 : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_EXPOSURE_MIP_5);
     #endif
+    #if defined FSR2_BIND_UAV_LUMA_MIP_0
+        RWTexture2D<FfxFloat32> rw_luma_mip_0 : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_LUMA_MIP_0);
+    #endif
     #if defined FSR2_BIND_UAV_DILATED_REACTIVE_MASKS
         RWTexture2D<unorm FfxFloat32x2> rw_dilated_reactive_masks : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_DILATED_REACTIVE_MASKS);
     #endif
+    #if defined FSR2_BIND_UAV_DEPTH_CLIP
+        RWTexture2D<unorm FfxFloat32> rw_depth_clip : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_DEPTH_CLIP);
+    #endif
     #if defined FSR2_BIND_UAV_EXPOSURE
         RWTexture2D<FFXM_UAV_RG_QUALIFIER> rw_exposure : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_EXPOSURE);
     #endif
@@ -442,17 +490,40 @@ SamplerState s_LinearClamp : register(s1);
         RWTexture2D<float> rw_output_autoreactive : FFXM_FSR2_DECLARE_UAV(FSR2_BIND_UAV_AUTOREACTIVE);
     #endif
 
+#if defined(FSR2_BIND_SRV_LUMA_MIP_0)
+FfxFloat32 LoadLumaMip0(FfxUInt32x2 iPxPos)
+{
+    return r_luma_mip_0[iPxPos];
+}
+#endif
+
+#if defined(FSR2_BIND_UAV_LUMA_MIP_0)
+void StoreLumaMip0(FfxUInt32x2 iPxPos, FfxFloat32 fLogLuma)
+{
+    rw_luma_mip_0[iPxPos] = fLogLuma;
+}
+#endif
+
 #if defined(FSR2_BIND_SRV_SCENE_LUMINANCE_MIPS)
 FfxFloat32 LoadMipLuma(FfxUInt32x2 iPxPos, FfxUInt32 mipLevel)
 {
+#if FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID
+    // Only the shading change mip is stored, as mip 0.
+    return r_imgMips.mips[mipLevel - LumaMipLevelToUse()][iPxPos];
+#else
     return r_imgMips.mips[mipLevel][iPxPos];
+#endif
 }
 #endif
 
 #if defined(FSR2_BIND_SRV_SCENE_LUMINANCE_MIPS)
 FfxFloat32 SampleMipLuma(FfxFloat32x2 fUV, FfxUInt32 mipLevel)
 {
+#if FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID
+    return r_imgMips.SampleLevel(s_LinearClamp, fUV, mipLevel - LumaMipLevelToUse());
+#else
     return r_imgMips.SampleLevel(s_LinearClamp, fUV, mipLevel);
+#endif
 }
 #endif
 
@@ -488,12 +559,13 @@ FfxFloat32 SampleInputDepth(FfxFloat32x2 fUV)
 }
 #endif
 
-FfxFloat32 LoadReactiveMask(FfxUInt32x2 iPxPos)
+// Returns the reactive mask in x and the transparency and composition mask in y.
+FFXM_MIN16_F2 LoadReactiveAndCompositionMasks(FfxUInt32x2 iPxPos)
 {
-#if defined(FSR2_BIND_SRV_REACTIVE_MASK)
-    return r_reactive_mask[iPxPos];
+#if defined(FSR2_BIND_SRV_REACTIVE_AND_COMPOSITION_MASKS)
+    return FFXM_MIN16_F2(r_reactive_and_composition_masks[iPxPos]);
 #else
-    return 0.0;
+    return FFXM_MIN16_F2(0.0, 0.0);
 #endif
 }
 
@@ -503,47 +575,21 @@ FfxFloat32 LoadReactiveMask(FfxUInt32x2 iPxPos)
                 |      |
    col01 (-1,0) *------* col11 (0,0)
 */
-void GatherReactiveRQuad(FfxFloat32x2 fUV,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col00,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col10,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col01,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col11)
-{
-#if defined(FSR2_BIND_SRV_REACTIVE_MASK)
-    FFXM_MIN16_F4 rrrr = r_reactive_mask.GatherRed(s_PointClamp, fUV);
-    col01 = FFXM_MIN16_F(rrrr.x);
-    col11 = FFXM_MIN16_F(rrrr.y);
-    col10 = FFXM_MIN16_F(rrrr.z);
-    col00 = FFXM_MIN16_F(rrrr.w);
-#endif
-}
-
-FfxFloat32 LoadTransparencyAndCompositionMask(FfxUInt32x2 iPxPos)
+void GatherReactiveAndCompositionMasksRGQuad(FfxFloat32x2 fUV,
+    FFXM_PARAMETER_INOUT FFXM_MIN16_F2 col00,
+    FFXM_PARAMETER_INOUT FFXM_MIN16_F2 col10,
+    FFXM_PARAMETER_INOUT FFXM_MIN16_F2 col01,
+    FFXM_PARAMETER_INOUT FFXM_MIN16_F2 col11)
 {
-#if defined(FSR2_BIND_SRV_TRANSPARENCY_AND_COMPOSITION_MASK)
-    return r_transparency_and_composition_mask[iPxPos];
+#if defined(FSR2_BIND_SRV_REACTIVE_AND_COMPOSITION_MASKS)
+    FFXM_MIN16_F4 rrrr = r_reactive_and_composition_masks.GatherRed(s_PointClamp, fUV);
+    FFXM_MIN16_F4 gggg = r_reactive_and_composition_masks.GatherGreen(s_PointClamp, fUV);
+    col01 = FFXM_MIN16_F2(rrrr.x, gggg.x);
+    col11 = FFXM_MIN16_F2(rrrr.y, gggg.y);
+    col10 = FFXM_MIN16_F2(rrrr.z, gggg.z);
+    col00 = FFXM_MIN16_F2(rrrr.w, gggg.w);
 #else
-    return 0.0;
-#endif
-}
-/*
-   col00 (-1,1) *------* col10 (0,-1)
-                |      |
-                |      |
-   col01 (-1,0) *------* col11 (0,0)
-*/
-void GatherTransparencyAndCompositionMaskRQuad(FfxFloat32x2 fUV,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col00,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col10,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col01,
-    FFXM_PARAMETER_INOUT FFXM_MIN16_F col11)
-{
-#if defined(FSR2_BIND_SRV_TRANSPARENCY_AND_COMPOSITION_MASK)
-    FFXM_MIN16_F4 rrrr = r_transparency_and_composition_mask.GatherRed(s_PointClamp, fUV);
-    col01 = FFXM_MIN16_F(rrrr.x);
-    col11 = FFXM_MIN16_F(rrrr.y);
-    col10 = FFXM_MIN16_F(rrrr.z);
-    col00 = FFXM_MIN16_F(rrrr.w);
+    col00 = col10 = col01 = col11 = FFXM_MIN16_F2(0.0, 0.0);
 #endif
 }
 
@@ -612,6 +658,23 @@ void GatherPreparedInputColorRGBQuad(FfxFloat32x2 fUV,
 }
 #endif
 
+#if defined(FSR2_BIND_SRV_UPSAMPLE_WEIGHTS)
+FFXM_MIN16_F4 LoadUpsampleWeights(FfxInt32 iIndex)
+{
+    return FFXM_MIN16_F4(r_upsample_weights[iIndex]);
+}
+#endif
+
+#if defined(FSR2_BIND_SRV_LANCZOS_LUT)
+// Lanczos2 of a squared distance. The texels cover x*x in [0, 4], so larger distances clamp to the zero at x = 2.
+FfxFloat32 SampleLanczos2WeightSq(FfxFloat32 x2)
+{
+    const FfxFloat32 fTexelScale = FfxFloat32(FFXM_FSR2_LANCZOS_LUT_WIDTH - 1) / FfxFloat32(FFXM_FSR2_LANCZOS_LUT_WIDTH);
+    const FfxFloat32 fTexelOffset = 0.5f / FfxFloat32(FFXM_FSR2_LANCZOS_LUT_WIDTH);
+    return r_lanczos_lut.SampleLevel(s_LinearClamp, FfxFloat32x2(x2 * 0.25f * fTexelScale + fTexelOffset, 0.5f), 0);
+}
+#endif
+
 #if defined(FSR2_BIND_SRV_INPUT_MOTION_VECTORS)
 FFXM_MIN16_F2 LoadInputMotionVector(FfxUInt32x2 iPxDilatedMotionVectorPos)
 {
@@ -691,11 +754,18 @@ void StoreLumaHistory(FfxUInt32x2 iPxPos, FfxFloat32x4 fLumaHistory)
 #endif
 
 #if defined(FSR2_BIND_SRV_LUMA_HISTORY)
+#if FFXM_FSR2_OPTION_LUMA_MOMENTS
+FFXM_MIN16_F2 SampleLumaMoments(FfxFloat32x2 fUV)
+{
+    return r_luma_history.SampleLevel(s_LinearClamp, fUV, 0);
+}
+#else
 FFXM_MIN16_F4 SampleLumaHistory(FfxFloat32x2 fUV)
 {
     return r_luma_history.SampleLevel(s_LinearClamp, fUV, 0);
 }
 #endif
+#endif
 
 FFXM_MIN16_F4 LoadRCAS_Input(FfxInt32x2 iPxPos)
 {
@@ -706,6 +776,15 @@ FFXM_MIN16_F4 LoadRCAS_Input(FfxInt32x2 iPxPos)
 #endif
 }
 
+FFXM_MIN16_F4 SampleRCAS_Input(FfxFloat32x2 fUV)
+{
+#if defined(FSR2_BIND_SRV_RCAS_INPUT)
+    return FFXM_MIN16_F4(r_rcas_input.SampleLevel(s_LinearClamp, fUV, 0));
+#else
+    return 0.0;
+#endif
+}
+
 #if defined(FSR2_BIND_UAV_INTERNAL_UPSCALED)
 void StoreReprojectedHistory(FfxUInt32x2 iPxHistory, FfxFloat32x4 fHistory)
 {
@@ -743,6 +822,20 @@ void StoreLockStatus(FfxUInt32x2 iPxPos, FfxFloat32x2 fLockStatus)
 }
 #endif
 
+#if defined(FSR2_BIND_UAV_RENDER_RES_LOCK_STATUS)
+void StoreRenderResLockStatus(FfxUInt32x2 iPxLrPos, FfxFloat32x2 fLockStatus)
+{
+    rw_render_res_lock_status[iPxLrPos] = fLockStatus;
+}
+#endif
+
+#if defined(FSR2_BIND_UAV_RENDER_RES_TEMPORAL_REACTIVE)
+void StoreRenderResTemporalReactive(FfxUInt32x2 iPxLrPos, FfxFloat32 fTemporalReactive)
+{
+    rw_render_res_temporal_reactive[iPxLrPos] = fTemporalReactive;
+}
+#endif
+
 FFXM_MIN16_F LoadLockInputLuma(FfxUInt32x2 iPxPos)
 {
 #if defined(FSR2_BIND_SRV_LOCK_INPUT_LUMA)
@@ -798,11 +891,37 @@ void StoreNewLocks(FfxUInt32x2 iPxPos, FfxFloat32 newLock)
 }
 #endif
 
+#if defined(FSR2_BIND_UAV_DILATED_REACTIVE_MASKS)
+void StoreDilatedReactiveMasks(FfxUInt32x2 iPxPos, FfxFloat32x2 fDilatedReactiveMasks)
+{
+    rw_dilated_reactive_masks[iPxPos] = fDilatedReactiveMasks;
+}
+#endif
+
+#if defined(FSR2_BIND_UAV_PREPARED_INPUT_COLOR)
+void StorePreparedInputColor(FfxUInt32x2 iPxPos, FfxFloat32x4 fTonemapped)
+{
+    rw_prepared_input_color[iPxPos] = fTonemapped;
+}
+#endif
+
+#if defined(FSR2_BIND_UAV_DEPTH_CLIP)
+void StoreDepthClip(FfxUInt32x2 iPxPos, FfxFloat32 fDepthClip)
+{
+    rw_depth_clip[iPxPos] = fDepthClip;
+}
+#endif
+
 #if defined(FSR2_BIND_SRV_PREPARED_INPUT_COLOR)
 FfxFloat32 SampleDepthClip(FfxFloat32x2 fUV)
 {
     return r_prepared_input_color.SampleLevel(s_LinearClamp, fUV, 0).w;
 }
+#elif defined(FSR2_BIND_SRV_DEPTH_CLIP)
+FfxFloat32 SampleDepthClip(FfxFloat32x2 fUV)
+{
+    return r_depth_clip.SampleLevel(s_LinearClamp, fUV, 0);
+}
 #endif
 
 #if defined(FSR2_BIND_SRV_LOCK_STATUS)
@@ -813,10 +932,42 @@ FFXM_MIN16_F2 SampleLockStatus(FfxFloat32x2 fUV)
 }
 #endif
 
+#if FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH
+// Depths in [0, 1] fit in the low 30 bits, keep the top 24 of those and put the epoch above them.
+// Standard depth is flipped so both depth conventions keep the nearest sample with InterlockedMax.
+FfxUInt32 EncodeReconstructedDepth(FfxFloat32 fDepth)
+{
+    FfxUInt32 uDepth = asuint(fDepth) >> 6;
+#if !FFXM_FSR2_OPTION_INVERTED_DEPTH
+    uDepth = 0xFFFFFFu - uDepth;
+#endif
+    return (ReconstructedDepthEpoch() << 24) | uDepth;
+}
+
+FfxFloat32 DecodeReconstructedDepth(FfxUInt32 uValue)
+{
+    // Written in an earlier frame, so treat it like the cleared value.
+    if ((uValue >> 24) != ReconstructedDepthEpoch())
+    {
+        return 0.0f;
+    }
+
+    FfxUInt32 uDepth = uValue & 0xFFFFFFu;
+#if !FFXM_FSR2_OPTION_INVERTED_DEPTH
+    uDepth = 0xFFFFFFu - uDepth;
+#endif
+    return asfloat(uDepth << 6);
+}
+#endif
+
 #if defined(FSR2_BIND_SRV_RECONSTRUCTED_PREV_NEAREST_DEPTH)
 FfxFloat32 LoadReconstructedPrevDepth(FfxUInt32x2 iPxPos)
 {
+#if FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH
+    return DecodeReconstructedDepth(r_reconstructed_previous_nearest_depth[iPxPos]);
+#else
     return asfloat(r_reconstructed_previous_nearest_depth[iPxPos]);
+#endif
 }
 /*
    d00 (-1,1) *------* d10 (0,-1)
@@ -831,16 +982,27 @@ void GatherReconstructedPreviousDepthRQuad(FfxFloat32x2 fUV,
     FFXM_PARAMETER_INOUT FfxFloat32 d11)
 {
     FfxUInt32x4 rrrr = r_reconstructed_previous_nearest_depth.GatherRed(s_PointClamp, fUV);
+#if FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH
+    d01 = DecodeReconstructedDepth(rrrr.x);
+    d11 = DecodeReconstructedDepth(rrrr.y);
+    d10 = DecodeReconstructedDepth(rrrr.z);
+    d00 = DecodeReconstructedDepth(rrrr.w);
+#else
     d01 = FfxFloat32(asfloat(rrrr.x));
     d11 = FfxFloat32(asfloat(rrrr.y));
     d10 = FfxFloat32(asfloat(rrrr.z));
     d00 = FfxFloat32(asfloat(rrrr.w));
+#endif
 }
 #endif
 
 #if defined(FSR2_BIND_UAV_RECONSTRUCTED_PREV_NEAREST_DEPTH)
 void StoreReconstructedDepth(FfxUInt32x2 iPxSample, FfxFloat32 fDepth)
 {
+#if FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH
+    // Stale values from earlier frames have a lower epoch, so the first store of this frame always replaces them.
+    InterlockedMax(rw_reconstructed_previous_nearest_depth[iPxSample], EncodeReconstructedDepth(fDepth));
+#else
     FfxUInt32 uDepth = asuint(fDepth);
 
     #if FFXM_FSR2_OPTION_INVERTED_DEPTH
@@ -848,6 +1010,7 @@ void StoreReconstructedDepth(FfxUInt32x2 iPxSample, FfxFloat32 fDepth)
     #else
         InterlockedMin(rw_reconstructed_previous_nearest_depth[iPxSample], uDepth); // min for standard, max for inverted depth
     #endif
+#endif
 }
 #endif
 
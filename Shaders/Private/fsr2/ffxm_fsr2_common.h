@@ -389,6 +389,34 @@ FFXM_MIN16_I2 ClampLoad(FFXM_MIN16_I2 iPxSample, FFXM_MIN16_I2 iPxOffset, FFXM_M
 }
 #endif
 
+FfxInt32x2 ReconstructedPrevDepthSize()
+{
+#if FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH
+    return (RenderSize() + 1) >> 1;
+#else
+    return RenderSize();
+#endif
+}
+
+// Remaps a row-major thread group id so that consecutive groups walk vertical strips uStripWidth groups wide, and the groups
+// in flight together read neighboring tiles. The last strip is narrower when uStripWidth does not divide the group count.
+// Returns the id unchanged when uStripWidth is 0.
+FfxUInt32x2 SwizzleGroupId(FfxUInt32x2 uGroupId, FfxUInt32x2 uGroupCount, FfxUInt32 uStripWidth)
+{
+    if (uStripWidth == 0u)
+    {
+        return uGroupId;
+    }
+
+    const FfxUInt32 uFlatGroupId = uGroupId.y * uGroupCount.x + uGroupId.x;
+    const FfxUInt32 uGroupsPerStrip = uStripWidth * uGroupCount.y;
+    const FfxUInt32 uStrip = uFlatGroupId / uGroupsPerStrip;
+    const FfxUInt32 uIdInStrip = uFlatGroupId % uGroupsPerStrip;
+    const FfxUInt32 uWidth = ffxMin(uStripWidth, uGroupCount.x - uStrip * uStripWidth);
+
+    return FfxUInt32x2(uStrip * uStripWidth + uIdInStrip % uWidth, uIdInStrip / uWidth);
+}
+
 FfxFloat32x2 ClampUv(FfxFloat32x2 fUv, FfxInt32x2 iTextureSize, FfxInt32x2 iResourceSize)
 {
     const FfxFloat32x2 fSampleLocation = fUv * iTextureSize;
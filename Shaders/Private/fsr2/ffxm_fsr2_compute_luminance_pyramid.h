@@ -45,6 +45,10 @@ FFXM_GROUPSHARED FfxFloat32 spdIntermediateA[16][16];
 
 FfxFloat32x4 SpdLoadSourceImage(FfxFloat32x2 tex, FfxUInt32 slice)
 {
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+    // Depth Clip already wrote the first level, out of bounds loads contribute no value like out of screen pixels.
+    return FfxFloat32x4(LoadLumaMip0(FfxUInt32x2(tex)), 0, 0, 0);
+#else
     FfxFloat32x2 fUv = (tex + 0.5f + Jitter()) / RenderSize();
     fUv = ClampUv(fUv, RenderSize(), InputColorResourceDimensions());
     FfxFloat32x3 fRgb = SampleInputColor(fUv);
@@ -58,6 +62,7 @@ FfxFloat32x4 SpdLoadSourceImage(FfxFloat32x2 tex, FfxUInt32 slice)
     const FfxFloat32 result = all(FFXM_LESS_THAN(tex, RenderSize())) ? fLogLuma : 0.0f;
 
     return FfxFloat32x4(result, 0, 0, 0);
+#endif
 }
 
 FfxFloat32x4 SpdLoad(FfxInt32x2 tex, FfxUInt32 slice)
@@ -67,6 +72,19 @@ FfxFloat32x4 SpdLoad(FfxInt32x2 tex, FfxUInt32 slice)
 
 void SpdStore(FfxInt32x2 pix, FfxFloat32x4 outValue, FfxUInt32 index, FfxUInt32 slice)
 {
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+    // The source is already the first level, so each output is one mip further down.
+    if (index + 1 == LumaMipLevelToUse())
+    {
+        SPD_SetMipmap(pix, index + 1, outValue.r);
+    }
+#elif FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID
+    // The dispatch stops at the shading change mip, there is no 1x1 level to accumulate.
+    if (index == LumaMipLevelToUse())
+    {
+        SPD_SetMipmap(pix, index, outValue.r);
+    }
+#else
     if (index == LumaMipLevelToUse() || index == 5)
     {
         SPD_SetMipmap(pix, index, outValue.r);
@@ -88,6 +106,7 @@ void SpdStore(FfxInt32x2 pix, FfxFloat32x4 outValue, FfxUInt32 index, FfxUInt32
             SPD_SetExposureBuffer(spdOutput);
         }
     }
+#endif
 }
 
 FfxFloat32x4 SpdLoadIntermediate(FfxUInt32 x, FfxUInt32 y)
@@ -119,6 +138,9 @@ FFXM_GROUPSHARED FfxFloat16x2 spdIntermediateBA[16][16];
 
 FfxFloat16x4 SpdLoadSourceImageH(FfxFloat32x2 tex, FfxUInt32 slice)
 {
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+    return FfxFloat16x4(LoadLumaMip0(FfxUInt32x2(tex)), 0, 0, 0);
+#else
     FfxFloat16x2 fUv = FfxFloat16x2((tex + 0.5f + Jitter()) / RenderSize());
     fUv = FfxFloat16x2(ClampUv(fUv, RenderSize(), InputColorResourceDimensions()));
     FfxFloat16x3 fRgb = FfxFloat16x3(SampleInputColor(fUv));
@@ -132,6 +154,7 @@ FfxFloat16x4 SpdLoadSourceImageH(FfxFloat32x2 tex, FfxUInt32 slice)
     const FfxFloat16 result = all(FFXM_LESS_THAN(tex, RenderSize())) ? fLogLuma : FfxFloat16(0.0f);
 
     return FfxFloat16x4(result, 0, 0, 0);
+#endif
 }
 
 FfxFloat16x4 SpdLoadH(FfxInt32x2 p, FfxUInt32 slice)
@@ -141,6 +164,17 @@ FfxFloat16x4 SpdLoadH(FfxInt32x2 p, FfxUInt32 slice)
 
 void SpdStoreH(FfxInt32x2 pix, FfxFloat16x4 outValue, FfxUInt32 index, FfxUInt32 slice)
 {
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+    if (index + 1 == LumaMipLevelToUse())
+    {
+        SPD_SetMipmap(pix, index + 1, outValue.r);
+    }
+#elif FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID
+    if (index == LumaMipLevelToUse())
+    {
+        SPD_SetMipmap(pix, index, outValue.r);
+    }
+#else
     if (index == LumaMipLevelToUse() || index == 5)
     {
         SPD_SetMipmap(pix, index, outValue.r);
@@ -165,6 +199,7 @@ void SpdStoreH(FfxInt32x2 pix, FfxFloat16x4 outValue, FfxUInt32 index, FfxUInt32
             SPD_SetExposureBuffer(spdOutput);
         }
     }
+#endif
 }
 
 FfxFloat16x4 SpdLoadIntermediateH(FfxUInt32 x, FfxUInt32 y)
@@ -20,12 +20,20 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+#define FSR2_BIND_SRV_LUMA_MIP_0                      0
+#else
 #define FSR2_BIND_SRV_INPUT_COLOR                     0
+#endif
 
+#if FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID
+#define FSR2_BIND_UAV_EXPOSURE_MIP_LUMA_CHANGE        2
+#else
 #define FSR2_BIND_UAV_SPD_GLOBAL_ATOMIC               1
 #define FSR2_BIND_UAV_EXPOSURE_MIP_LUMA_CHANGE        2
 #define FSR2_BIND_UAV_EXPOSURE_MIP_5                  3
 #define FSR2_BIND_UAV_AUTO_EXPOSURE                   4
+#endif
 
 #define FSR2_BIND_CB_FSR2                             0
 #define FSR2_BIND_CB_SPD                              1
@@ -36,10 +36,98 @@ struct DepthClipOutputs
 
 FFXM_STATIC const FfxFloat32 DepthClipBaseScale = 4.0f;
 
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+#define DEPTH_CLIP_TILE_WIDTH (FFXM_FSR2_THREAD_GROUP_WIDTH + 2)
+#define DEPTH_CLIP_TILE_HEIGHT (FFXM_FSR2_THREAD_GROUP_HEIGHT + 2)
+
+FFXM_GROUPSHARED FfxFloat32x2 gs_InputMotionVectors[DEPTH_CLIP_TILE_HEIGHT][DEPTH_CLIP_TILE_WIDTH];
+FFXM_GROUPSHARED FfxFloat32 gs_DilatedDepth[DEPTH_CLIP_TILE_HEIGHT][DEPTH_CLIP_TILE_WIDTH];
+#if !FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH
+FFXM_GROUPSHARED FfxFloat32 gs_ReconstructedPrevDepth[DEPTH_CLIP_TILE_HEIGHT][DEPTH_CLIP_TILE_WIDTH];
+#endif
+#if !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+FFXM_GROUPSHARED FfxFloat32x2 gs_ReactiveAndCompositionMasks[DEPTH_CLIP_TILE_HEIGHT][DEPTH_CLIP_TILE_WIDTH];
+#endif
+
+// Position of iPxPos + iOffset in the tile staged by the group that processes iPxPos, for offsets within the halo.
+FfxInt32x2 DepthClipTilePos(FfxInt32x2 iPxPos, FfxInt32x2 iOffset)
+{
+    return (iPxPos % FfxInt32x2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT)) + iOffset + FfxInt32x2(1, 1);
+}
+
+// Every thread of the group must call this, before DepthClip. The halo is clamped to the render size.
+void StageDepthClipTile(FfxInt32x2 iGroupOrigin, FfxInt32 iThreadIndex)
+{
+    const FfxInt32 iThreadCount = FFXM_FSR2_THREAD_GROUP_WIDTH * FFXM_FSR2_THREAD_GROUP_HEIGHT;
+    for (FfxInt32 iTileIndex = iThreadIndex; iTileIndex < DEPTH_CLIP_TILE_WIDTH * DEPTH_CLIP_TILE_HEIGHT; iTileIndex += iThreadCount)
+    {
+        const FfxInt32x2 iTilePos = FfxInt32x2(iTileIndex % DEPTH_CLIP_TILE_WIDTH, iTileIndex / DEPTH_CLIP_TILE_WIDTH);
+        const FfxInt32x2 iPxPos = clamp(iGroupOrigin + iTilePos - FfxInt32x2(1, 1), FfxInt32x2(0, 0), RenderSize() - FfxInt32x2(1, 1));
+
+        gs_InputMotionVectors[iTilePos.y][iTilePos.x] = LoadInputMotionVector(iPxPos);
+        gs_DilatedDepth[iTilePos.y][iTilePos.x] = LoadDilatedDepth(iPxPos);
+#if !FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH
+        gs_ReconstructedPrevDepth[iTilePos.y][iTilePos.x] = LoadReconstructedPrevDepth(iPxPos);
+#endif
+#if !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+        gs_ReactiveAndCompositionMasks[iTilePos.y][iTilePos.x] = LoadReactiveAndCompositionMasks(iPxPos);
+#endif
+    }
+
+    FFXM_GROUP_MEMORY_BARRIER();
+}
+#endif
+
+#if FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD
+// Pixel shader only, outside divergent control flow. Each pixel of a 2x2 quad fetches the 2x2 texels at
+// iPxPos - 1 + uQuadPos + (0|1, 0|1) with a single gather (fOwn00..fOwn11), which together cover the 4x4 footprint
+// of the quad's 3x3 neighborhoods; the five samples a pixel did not fetch are read from the other pixels of the quad.
+void QuadShuffleNeighborhood(FfxUInt32x2 uQuadPos, FfxFloat32 fOwn00, FfxFloat32 fOwn10, FfxFloat32 fOwn01, FfxFloat32 fOwn11,
+    FFXM_PARAMETER_OUT FfxFloat32 fSamples[9])
+{
+    const FfxBoolean bMirrorX = uQuadPos.x != 0;
+    const FfxBoolean bMirrorY = uQuadPos.y != 0;
+
+    // Mirror the fetched texels so that the quad centre is towards +x and +y: .x is the outer column, .y the pixel's own.
+    const FfxFloat32x2 fRow0 = bMirrorX ? FfxFloat32x2(fOwn10, fOwn00) : FfxFloat32x2(fOwn00, fOwn10);
+    const FfxFloat32x2 fRow1 = bMirrorX ? FfxFloat32x2(fOwn11, fOwn01) : FfxFloat32x2(fOwn01, fOwn11);
+    const FfxFloat32x2 fOuterRow = bMirrorY ? fRow1 : fRow0;
+    const FfxFloat32x2 fInnerRow = bMirrorY ? fRow0 : fRow1;
+
+    // The neighbours share one axis of the mirroring, so their own column, own row and own pixel are what this pixel lacks.
+    const FfxFloat32x2 fAcrossX = QuadReadAcrossX(FfxFloat32x2(fOuterRow.y, fInnerRow.y));
+    const FfxFloat32x2 fAcrossY = QuadReadAcrossY(fInnerRow);
+    const FfxFloat32 fAcrossDiagonal = QuadReadAcrossDiagonal(fInnerRow.y);
+
+    FfxFloat32x3 fMirrored0 = FfxFloat32x3(fOuterRow, fAcrossX.x);
+    FfxFloat32x3 fMirrored1 = FfxFloat32x3(fInnerRow, fAcrossX.y);
+    FfxFloat32x3 fMirrored2 = FfxFloat32x3(fAcrossY, fAcrossDiagonal);
+    if (bMirrorX)
+    {
+        fMirrored0 = fMirrored0.zyx;
+        fMirrored1 = fMirrored1.zyx;
+        fMirrored2 = fMirrored2.zyx;
+    }
+    const FfxFloat32x3 fTop = bMirrorY ? fMirrored2 : fMirrored0;
+    const FfxFloat32x3 fBottom = bMirrorY ? fMirrored0 : fMirrored2;
+
+    fSamples[0] = fTop.x;
+    fSamples[1] = fTop.y;
+    fSamples[2] = fTop.z;
+    fSamples[3] = fMirrored1.x;
+    fSamples[4] = fMirrored1.y;
+    fSamples[5] = fMirrored1.z;
+    fSamples[6] = fBottom.x;
+    fSamples[7] = fBottom.y;
+    fSamples[8] = fBottom.z;
+}
+#endif
+
 FfxFloat32 ComputeDepthClip(FfxFloat32x2 fUvSample, FfxFloat32 fCurrentDepthSample)
 {
     FfxFloat32 fCurrentDepthViewSpace = GetViewSpaceDepth(fCurrentDepthSample);
-    BilinearSamplingData bilinearInfo = GetBilinearSamplingData(fUvSample, RenderSize());
+    const FfxInt32x2 iPrevDepthSize = ReconstructedPrevDepthSize();
+    BilinearSamplingData bilinearInfo = GetBilinearSamplingData(fUvSample, iPrevDepthSize);
 
     FfxFloat32 fDilatedSum = 0.0f;
     FfxFloat32 fDepth = 0.0f;
@@ -57,7 +145,7 @@ FfxFloat32 ComputeDepthClip(FfxFloat32x2 fUvSample, FfxFloat32 fCurrentDepthSamp
         const FfxInt32x2 iOffset = bilinearInfo.iOffsets[iSampleIndex];
         const FfxInt32x2 iSamplePos = bilinearInfo.iBasePos + iOffset;
 
-        if (IsOnScreen(iSamplePos, RenderSize()))
+        if (IsOnScreen(iSamplePos, iPrevDepthSize))
         {
             const FfxFloat32 fWeight = bilinearInfo.fWeights[iSampleIndex];
             if (fWeight > fReconstructedDepthBilinearWeightThreshold)
@@ -104,18 +192,46 @@ FfxFloat32 ComputeMotionDivergence(FfxInt32x2 iPxPos, FfxInt32x2 iPxInputMotionV
 {
     FfxFloat32 minconvergence = 1.0f;
 
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+    const FfxInt32x2 iNucleusTilePos = DepthClipTilePos(iPxPos, FfxInt32x2(0, 0));
+    FfxFloat32x2 fMotionVectorNucleus = gs_InputMotionVectors[iNucleusTilePos.y][iNucleusTilePos.x];
+#else
     FfxFloat32x2 fMotionVectorNucleus = LoadInputMotionVector(iPxPos);
+#endif
     FfxFloat32 fNucleusVelocityLr = length(fMotionVectorNucleus * RenderSize());
     FfxFloat32 fMaxVelocityUv = length(fMotionVectorNucleus);
 
     const FfxFloat32 MotionVectorVelocityEpsilon = 1e-02f;
 
 
+    FFXM_MIN16_F2 fMotionVectorSamples[9];
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        const FfxInt32x2 iTilePos = DepthClipTilePos(iPxPos, FfxInt32x2(iSample % 3, iSample / 3) - FfxInt32x2(1, 1));
+        fMotionVectorSamples[iSample] = FFXM_MIN16_F2(gs_InputMotionVectors[iTilePos.y][iTilePos.x]);
+    }
+#elif FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD && FFXM_FSR2_OPTION_LOW_RESOLUTION_MOTION_VECTORS
+    // Display resolution motion vectors are sampled at positions that are not adjacent within the quad.
+    const FfxUInt32x2 uQuadPos = FfxUInt32x2(iPxPos) & 1u;
+    FFXM_MIN16_F2 fOwn[4];
+    GatherInputMotionVectorRGQuad(FfxFloat32x2(iPxPos + FfxInt32x2(uQuadPos)) / FfxFloat32x2(iPxInputMotionVectorSize),
+        fOwn[0], fOwn[1], fOwn[2], fOwn[3]);
+    FfxFloat32 fSamplesX[9];
+    FfxFloat32 fSamplesY[9];
+    QuadShuffleNeighborhood(uQuadPos, fOwn[0].x, fOwn[1].x, fOwn[2].x, fOwn[3].x, fSamplesX);
+    QuadShuffleNeighborhood(uQuadPos, fOwn[0].y, fOwn[1].y, fOwn[2].y, fOwn[3].y, fSamplesY);
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        fMotionVectorSamples[iSample] = FFXM_MIN16_F2(fSamplesX[iSample], fSamplesY[iSample]);
+    }
+#else
     const FfxFloat32x2 fMVSize = FfxFloat32x2(iPxInputMotionVectorSize);
     FfxFloat32x2 fPxBaseUv = FfxFloat32x2(iPxPos) / fMVSize;
     FfxFloat32x2 fUnitUv = FfxFloat32x2(1.0f, 1.0f) / fMVSize;
 
-    FFXM_MIN16_F2 fMotionVectorSamples[9];
     FFXM_MIN16_F2 fTmpDummy = FFXM_MIN16_F2(0.0f, 0.0f);
     GatherInputMotionVectorRGQuad(fPxBaseUv,
         fMotionVectorSamples[0], fMotionVectorSamples[1],
@@ -125,6 +241,7 @@ FfxFloat32 ComputeMotionDivergence(FfxInt32x2 iPxPos, FfxInt32x2 iPxInputMotionV
         fMotionVectorSamples[7], fMotionVectorSamples[8]);
     fMotionVectorSamples[2] = LoadInputMotionVector(iPxPos + FfxInt32x2(1, -1));
     fMotionVectorSamples[6] = LoadInputMotionVector(iPxPos + FfxInt32x2(-1, 1));
+#endif
 
     if (fNucleusVelocityLr > MotionVectorVelocityEpsilon) {
         for (FfxInt32 y = -1; y <= 1; ++y)
@@ -155,11 +272,26 @@ FfxFloat32 ComputeDepthDivergence(FfxInt32x2 iPxPos)
     FfxInt32 iMaxDistFound = 0;
 
     FfxInt32x2 iRenderSize = RenderSize();
+
+    FfxFloat32 fDilatedDepthSamples[9];
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        const FfxInt32x2 iTilePos = DepthClipTilePos(iPxPos, FfxInt32x2(iSample % 3, iSample / 3) - FfxInt32x2(1, 1));
+        fDilatedDepthSamples[iSample] = gs_DilatedDepth[iTilePos.y][iTilePos.x];
+    }
+#elif FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD
+    const FfxUInt32x2 uQuadPos = FfxUInt32x2(iPxPos) & 1u;
+    FfxFloat32 fOwn[4];
+    GatherDilatedDepthRQuad(FfxFloat32x2(iPxPos + FfxInt32x2(uQuadPos)) / FfxFloat32x2(iRenderSize),
+        fOwn[0], fOwn[1], fOwn[2], fOwn[3]);
+    QuadShuffleNeighborhood(uQuadPos, fOwn[0], fOwn[1], fOwn[2], fOwn[3], fDilatedDepthSamples);
+#else
     const FfxFloat32x2 fRenderSize = FfxFloat32x2(iRenderSize);
     FfxFloat32x2 fPxPosBase = FfxFloat32x2(iPxPos) / fRenderSize;
     FfxFloat32x2 fUnitUv = FfxFloat32x2(1.0f, 1.0f) / fRenderSize;
 
-    FfxFloat32 fDilatedDepthSamples[9];
     FfxFloat32 fTmpDummy = 0.0f;
     GatherDilatedDepthRQuad(fPxPosBase,
         fDilatedDepthSamples[0], fDilatedDepthSamples[1],
@@ -169,6 +301,7 @@ FfxFloat32 ComputeDepthDivergence(FfxInt32x2 iPxPos)
         fDilatedDepthSamples[7], fDilatedDepthSamples[8]);
     fDilatedDepthSamples[2] = LoadDilatedDepth(iPxPos + FfxInt32x2(1, -1));
     fDilatedDepthSamples[6] = LoadDilatedDepth(iPxPos + FfxInt32x2(-1, 1));
+#endif
 
     for (FfxInt32 y = -1; y < 2; y++)
     {
@@ -215,46 +348,53 @@ void PreProcessReactiveMasks(FfxInt32x2 iPxLrPos, FfxFloat32 fMotionDivergence,
 {
     // Compensate for bilinear sampling in accumulation pass
 
+    FFXM_MIN16_F2 fReactiveFactor = FFXM_MIN16_F2(0.0f, fMotionDivergence);
+    FFXM_MIN16_F fMasksSum = FFXM_MIN16_F(0.0f);
+
+    // Reactive (x) and transparency and composition (y) mask samples, packed in a single texture
+    FFXM_MIN16_F2 fMaskSamples[9];
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        const FfxInt32x2 iTilePos = DepthClipTilePos(iPxLrPos, FfxInt32x2(iSample % 3, iSample / 3) - FfxInt32x2(1, 1));
+        fMaskSamples[iSample] = FFXM_MIN16_F2(gs_ReactiveAndCompositionMasks[iTilePos.y][iTilePos.x]);
+    }
+#elif FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD
+    const FfxUInt32x2 uQuadPos = FfxUInt32x2(iPxLrPos) & 1u;
+    FFXM_MIN16_F2 fOwn[4];
+    GatherReactiveAndCompositionMasksRGQuad(FfxFloat32x2(iPxLrPos + FfxInt32x2(uQuadPos)) / FfxFloat32x2(RenderSize()),
+        fOwn[0], fOwn[1], fOwn[2], fOwn[3]);
+    FfxFloat32 fReactiveSamples[9];
+    FfxFloat32 fCompositionSamples[9];
+    QuadShuffleNeighborhood(uQuadPos, fOwn[0].x, fOwn[1].x, fOwn[2].x, fOwn[3].x, fReactiveSamples);
+    QuadShuffleNeighborhood(uQuadPos, fOwn[0].y, fOwn[1].y, fOwn[2].y, fOwn[3].y, fCompositionSamples);
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        fMaskSamples[iSample] = FFXM_MIN16_F2(fReactiveSamples[iSample], fCompositionSamples[iSample]);
+    }
+#else
     const FfxInt32x2 iRenderSize = RenderSize();
     const FfxFloat32x2 fRenderSize = FfxFloat32x2(iRenderSize);
     FfxFloat32x2 fPxPosBase = FfxFloat32x2(iPxLrPos) / fRenderSize;
     FfxFloat32x2 fUnitUv = FfxFloat32x2(1.0f, 1.0f) / fRenderSize;
 
-    FFXM_MIN16_F2 fReactiveFactor = FFXM_MIN16_F2(0.0f, fMotionDivergence);
-    FFXM_MIN16_F fMasksSum = FFXM_MIN16_F(0.0f);
-
-    FFXM_MIN16_F fTmpDummy = FFXM_MIN16_F(0.0f);
-    // Reactive samples
-    FFXM_MIN16_F fReactiveSamples[9];
-    GatherReactiveRQuad(fPxPosBase,
-        fReactiveSamples[0], fReactiveSamples[1],
-        fReactiveSamples[3], fReactiveSamples[4]);
-    GatherReactiveRQuad(fUnitUv + fPxPosBase,
-        fTmpDummy, fReactiveSamples[5],
-        fReactiveSamples[7], fReactiveSamples[8]);
-    fReactiveSamples[2] = FFXM_MIN16_F(LoadReactiveMask(iPxLrPos + FfxInt32x2(1, -1)));
-    fReactiveSamples[6] = FFXM_MIN16_F(LoadReactiveMask(iPxLrPos + FfxInt32x2(-1, 1)));
-
-    // Transparency and composition mask samples
-    FFXM_MIN16_F fTransparencyAndCompositionSamples[9];
-    GatherTransparencyAndCompositionMaskRQuad(fPxPosBase,
-        fTransparencyAndCompositionSamples[0], fTransparencyAndCompositionSamples[1],
-        fTransparencyAndCompositionSamples[3], fTransparencyAndCompositionSamples[4]);
-    GatherTransparencyAndCompositionMaskRQuad(fUnitUv + fPxPosBase,
-        fTmpDummy, fTransparencyAndCompositionSamples[5],
-        fTransparencyAndCompositionSamples[7], fTransparencyAndCompositionSamples[8]);
-    fTransparencyAndCompositionSamples[2] = FFXM_MIN16_F(LoadTransparencyAndCompositionMask(iPxLrPos + FfxInt32x2(1, -1)));
-    fTransparencyAndCompositionSamples[6] = FFXM_MIN16_F(LoadTransparencyAndCompositionMask(iPxLrPos + FfxInt32x2(-1, 1)));
+    FFXM_MIN16_F2 fTmpDummy = FFXM_MIN16_F2(0.0f, 0.0f);
+    GatherReactiveAndCompositionMasksRGQuad(fPxPosBase,
+        fMaskSamples[0], fMaskSamples[1],
+        fMaskSamples[3], fMaskSamples[4]);
+    GatherReactiveAndCompositionMasksRGQuad(fUnitUv + fPxPosBase,
+        fTmpDummy, fMaskSamples[5],
+        fMaskSamples[7], fMaskSamples[8]);
+    fMaskSamples[2] = LoadReactiveAndCompositionMasks(iPxLrPos + FfxInt32x2(1, -1));
+    fMaskSamples[6] = LoadReactiveAndCompositionMasks(iPxLrPos + FfxInt32x2(-1, 1));
+#endif
 
     FFXM_UNROLL
-    for (FfxInt32 y = -1; y < 2; y++)
+    for (FfxInt32 sampleIdx = 0; sampleIdx < 9; sampleIdx++)
     {
-        FFXM_UNROLL
-        for (FfxInt32 x = -1; x < 2; x++)
-        {
-            FfxInt32 sampleIdx = (y + 1) * 3 + x + 1;
-            fMasksSum += (fReactiveSamples[sampleIdx] + fTransparencyAndCompositionSamples[sampleIdx]);
-        }
+        fMasksSum += (fMaskSamples[sampleIdx].x + fMaskSamples[sampleIdx].y);
     }
 
     if (fMasksSum > FFXM_MIN16_F(0))
@@ -276,8 +416,8 @@ void PreProcessReactiveMasks(FfxInt32x2 iPxLrPos, FfxFloat32 fMotionDivergence,
         for (FfxInt32 sampleIdx = 0; sampleIdx < 9; sampleIdx++)
         {
             FFXM_MIN16_F3 fColorSample = fInputColorSamples[sampleIdx];
-            FFXM_MIN16_F fReactiveSample = fReactiveSamples[sampleIdx];
-            FFXM_MIN16_F fTransparencyAndCompositionSample = fTransparencyAndCompositionSamples[sampleIdx];
+            FFXM_MIN16_F fReactiveSample = fMaskSamples[sampleIdx].x;
+            FFXM_MIN16_F fTransparencyAndCompositionSample = fMaskSamples[sampleIdx].y;
 
             const FfxFloat32 fMaxLenSq = ffxMax(dot(fReferenceColor, fReferenceColor), dot(fColorSample, fColorSample));
             const FFXM_MIN16_F fSimilarity = dot(fReferenceColor, fColorSample) / fMaxLenSq;
@@ -315,9 +455,19 @@ FfxFloat32x3 ComputePreparedInputColor(FfxInt32x2 iPxLrPos)
 
 FfxFloat32 EvaluateSurface(FfxInt32x2 iPxPos, FfxFloat32x2 fMotionVector)
 {
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD && !FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH
+    const FfxInt32x2 iTilePos = DepthClipTilePos(iPxPos, FfxInt32x2(0, 0));
+    FfxFloat32 d0 = GetViewSpaceDepth(gs_ReconstructedPrevDepth[iTilePos.y - 1][iTilePos.x]);
+    FfxFloat32 d1 = GetViewSpaceDepth(gs_ReconstructedPrevDepth[iTilePos.y][iTilePos.x]);
+    FfxFloat32 d2 = GetViewSpaceDepth(gs_ReconstructedPrevDepth[iTilePos.y + 1][iTilePos.x]);
+#else
+#if FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH
+    iPxPos >>= 1;
+#endif
     FfxFloat32 d0 = GetViewSpaceDepth(LoadReconstructedPrevDepth(iPxPos + FfxInt32x2(0, -1)));
     FfxFloat32 d1 = GetViewSpaceDepth(LoadReconstructedPrevDepth(iPxPos + FfxInt32x2(0, 0)));
     FfxFloat32 d2 = GetViewSpaceDepth(LoadReconstructedPrevDepth(iPxPos + FfxInt32x2(0, 1)));
+#endif
 
     return 1.0f - FfxFloat32(((d0 - d1) > (d1 * 0.01f)) && ((d1 - d2) > (d2 * 0.01f)));
 }
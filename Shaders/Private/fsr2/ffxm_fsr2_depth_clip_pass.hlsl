@@ -0,0 +1,92 @@
+// Copyright  © 2023 Advanced Micro Devices, Inc.
+// Copyright © 2024-2025 Arm Limited.
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+// Compute variant of ffxm_fsr2_depth_clip_pass_fs.hlsl. Each group stages its tile of the 3x3 neighborhoods in
+// groupshared memory, and the outputs are written through UAVs instead of render targets.
+
+#define FSR2_BIND_SRV_RECONSTRUCTED_PREV_NEAREST_DEPTH      0
+#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#define FSR2_BIND_SRV_DILATED_DEPTH_MOTION_VECTORS_INPUT_LUMA 1
+#define FSR2_BIND_SRV_PREV_DILATED_DEPTH_MOTION_VECTORS_INPUT_LUMA 2
+#else
+#define FSR2_BIND_SRV_DILATED_MOTION_VECTORS                1
+#define FSR2_BIND_SRV_DILATED_DEPTH                         2
+#define FSR2_BIND_SRV_REACTIVE_AND_COMPOSITION_MASKS       3
+#define FSR2_BIND_SRV_PREVIOUS_DILATED_MOTION_VECTORS       5
+#endif
+#define FSR2_BIND_SRV_INPUT_MOTION_VECTORS                  6
+#define FSR2_BIND_SRV_INPUT_COLOR                           7
+#define FSR2_BIND_SRV_INPUT_DEPTH                           8
+#if !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#define FSR2_BIND_SRV_INPUT_EXPOSURE                        9
+#endif
+
+#define FSR2_BIND_UAV_DILATED_REACTIVE_MASKS                0
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+#define FSR2_BIND_UAV_DEPTH_CLIP                            1
+#elif !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#define FSR2_BIND_UAV_PREPARED_INPUT_COLOR                  1
+#endif
+
+#define FSR2_BIND_CB_FSR2                                   0
+
+// The group size is also the groupshared tile size, so it is defined before the includes.
+#ifndef FFXM_FSR2_THREAD_GROUP_WIDTH
+#define FFXM_FSR2_THREAD_GROUP_WIDTH 8
+#endif // #ifndef FFXM_FSR2_THREAD_GROUP_WIDTH
+#ifndef FFXM_FSR2_THREAD_GROUP_HEIGHT
+#define FFXM_FSR2_THREAD_GROUP_HEIGHT 8
+#endif // #ifndef FFXM_FSR2_THREAD_GROUP_HEIGHT
+#ifndef FFXM_FSR2_THREAD_GROUP_DEPTH
+#define FFXM_FSR2_THREAD_GROUP_DEPTH 1
+#endif // #ifndef FFXM_FSR2_THREAD_GROUP_DEPTH
+#ifndef FFXM_FSR2_NUM_THREADS
+#define FFXM_FSR2_NUM_THREADS [numthreads(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT, FFXM_FSR2_THREAD_GROUP_DEPTH)]
+#endif // #ifndef FFXM_FSR2_NUM_THREADS
+
+#include "ffxm_fsr2_callbacks_hlsl.h"
+#include "ffxm_fsr2_common.h"
+#include "ffxm_fsr2_sample.h"
+#include "ffxm_fsr2_depth_clip.h"
+
+FFXM_PREFER_WAVE64
+FFXM_FSR2_NUM_THREADS
+FFXM_FSR2_EMBED_ROOTSIG_CONTENT
+void main(uint2 uGroupId : SV_GroupID, uint2 uGroupThreadId : SV_GroupThreadID)
+{
+    // The passes are dispatched over the render size.
+    const uint2 uGroupCount = (uint2(RenderSize()) + uint2(FFXM_FSR2_THREAD_GROUP_WIDTH - 1, FFXM_FSR2_THREAD_GROUP_HEIGHT - 1)) / uint2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT);
+    uGroupId = SwizzleGroupId(uGroupId, uGroupCount, GroupSwizzleWidth());
+
+    uint2 uDispatchThreadId = uGroupId * uint2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT) + uGroupThreadId;
+
+    StageDepthClipTile(uGroupId * uint2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT), uGroupThreadId.y * FFXM_FSR2_THREAD_GROUP_WIDTH + uGroupThreadId.x);
+
+    DepthClipOutputs result = DepthClip(uDispatchThreadId);
+    StoreDilatedReactiveMasks(uDispatchThreadId, result.fDilatedReactiveMasks);
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+    // Accumulate recomputes the prepared colour from the input colour.
+    StoreDepthClip(uDispatchThreadId, result.fTonemapped.w);
+#elif !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+    StorePreparedInputColor(uDispatchThreadId, result.fTonemapped);
+#endif
+}
@@ -27,8 +27,7 @@
 #else
 #define FSR2_BIND_SRV_DILATED_MOTION_VECTORS                1
 #define FSR2_BIND_SRV_DILATED_DEPTH                         2
-#define FSR2_BIND_SRV_REACTIVE_MASK                         3
-#define FSR2_BIND_SRV_TRANSPARENCY_AND_COMPOSITION_MASK     4
+#define FSR2_BIND_SRV_REACTIVE_AND_COMPOSITION_MASKS       3
 #define FSR2_BIND_SRV_PREVIOUS_DILATED_MOTION_VECTORS       5
 #endif
 #define FSR2_BIND_SRV_INPUT_MOTION_VECTORS                  6
@@ -38,6 +37,11 @@
 #define FSR2_BIND_SRV_INPUT_EXPOSURE                        9
 #endif
 
+// Pixel shader UAV slots follow the render targets on D3D11, so keep them clear of SV_TARGET0-3.
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+#define FSR2_BIND_UAV_LUMA_MIP_0                            4
+#endif
+
 #define FSR2_BIND_CB_FSR2                                   0
 
 #include "ffxm_fsr2_callbacks_hlsl.h"
@@ -54,18 +58,42 @@ struct VertexOut
 struct DepthClipOutputsFS
 {
     FfxFloat32x2 fDilatedReactiveMasks    : SV_TARGET0;
-#if !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+    FfxFloat32 fDepthClip                 : SV_TARGET1;
+#elif !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
     FfxFloat32x4 fTonemapped              : SV_TARGET1;
 #endif
 };
 
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+// Average over the 2x2 pixel quad, from the fine derivatives against the horizontal and vertical neighbours.
+FfxFloat32 QuadAverage(FfxFloat32 fValue, uint2 uPixelCoord)
+{
+    const FfxFloat32 fRowAverage = fValue + (((uPixelCoord.x & 1) != 0) ? -0.5f : 0.5f) * ddx_fine(fValue);
+    return fRowAverage + (((uPixelCoord.y & 1) != 0) ? -0.5f : 0.5f) * ddy_fine(fRowAverage);
+}
+#endif
+
 DepthClipOutputsFS main(float4 SvPosition : SV_POSITION)
 {
     uint2 uPixelCoord = uint2(SvPosition.xy);
+#if FFXM_FSR2_OPTION_FUSED_LUMA_MIP
+    // Same log luma and 2x2 reduction as the first level of Compute Luminance Pyramid, computed before any
+    // divergent control flow so that the derivatives are valid.
+    const FfxFloat32x3 fRgb = FfxFloat32x3(LoadInputColor(uPixelCoord)) / PreExposure();
+    const FfxFloat32 fQuadLogLuma = QuadAverage(log(ffxMax(FSR2_EPSILON, RGBToLuma(fRgb))), uPixelCoord);
+    if (((uPixelCoord.x | uPixelCoord.y) & 1) == 0)
+    {
+        StoreLumaMip0(uPixelCoord >> 1, fQuadLogLuma);
+    }
+#endif
     DepthClipOutputs result = DepthClip(uPixelCoord);
     DepthClipOutputsFS output = (DepthClipOutputsFS)0;
     output.fDilatedReactiveMasks = result.fDilatedReactiveMasks;
-#if !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+    // Accumulate recomputes the prepared colour from the input colour.
+    output.fDepthClip = result.fTonemapped.w;
+#elif !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
     output.fTonemapped = result.fTonemapped;
 #endif
     return output;
@@ -23,11 +23,63 @@
 #ifndef FFXM_FSR2_LOCK_H
 #define FFXM_FSR2_LOCK_H
 
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+// Same luma as Reconstruct Previous Depth stores when the option is disabled.
+FfxFloat32 ComputeLockInputLuma(FfxInt32x2 iPxLrPos)
+{
+    FfxFloat32x3 fRgb = ffxMax(FfxFloat32x3(0, 0, 0), LoadInputColor(iPxLrPos));
+
+    // Use internal auto exposure for locking logic
+    fRgb /= PreExposure();
+    fRgb *= Exposure();
+
+#if FFXM_FSR2_OPTION_HDR_COLOR_INPUT
+    fRgb = Tonemap(fRgb);
+#endif
+
+    return ffxPow(RGBToPerceivedLuma(fRgb), FfxFloat32(1.0 / 6.0));
+}
+#endif
+
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+#define LOCK_TILE_WIDTH (FFXM_FSR2_THREAD_GROUP_WIDTH + 2)
+#define LOCK_TILE_HEIGHT (FFXM_FSR2_THREAD_GROUP_HEIGHT + 2)
+
+FFXM_GROUPSHARED FfxFloat32 gs_LockInputLuma[LOCK_TILE_HEIGHT][LOCK_TILE_WIDTH];
+
+// Every thread of the group must call this, before ComputeLock. The halo is clamped to the render size, which also
+// makes each recomputed luma in the tile computed only once.
+void StageLockTile(FfxInt32x2 iGroupOrigin, FfxInt32 iThreadIndex)
+{
+    const FfxInt32 iThreadCount = FFXM_FSR2_THREAD_GROUP_WIDTH * FFXM_FSR2_THREAD_GROUP_HEIGHT;
+    for (FfxInt32 iTileIndex = iThreadIndex; iTileIndex < LOCK_TILE_WIDTH * LOCK_TILE_HEIGHT; iTileIndex += iThreadCount)
+    {
+        const FfxInt32x2 iTilePos = FfxInt32x2(iTileIndex % LOCK_TILE_WIDTH, iTileIndex / LOCK_TILE_WIDTH);
+        const FfxInt32x2 iPxPos = clamp(iGroupOrigin + iTilePos - FfxInt32x2(1, 1), FfxInt32x2(0, 0), RenderSize() - FfxInt32x2(1, 1));
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+        gs_LockInputLuma[iTilePos.y][iTilePos.x] = ComputeLockInputLuma(iPxPos);
+#else
+        gs_LockInputLuma[iTilePos.y][iTilePos.x] = LoadLockInputLuma(iPxPos);
+#endif
+    }
+
+    FFXM_GROUP_MEMORY_BARRIER();
+}
+#endif
+
 FfxBoolean ComputeThinFeatureConfidence(FfxInt32x2 pos)
 {
     const FfxInt32 RADIUS = 1;
 
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+    // Top left of the 3x3 neighborhood in the tile staged by this group.
+    const FfxInt32x2 iTileBase = pos % FfxInt32x2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT);
+    FFXM_MIN16_F fNucleus = FFXM_MIN16_F(gs_LockInputLuma[iTileBase.y + 1][iTileBase.x + 1]);
+#elif FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+    FFXM_MIN16_F fNucleus = FFXM_MIN16_F(ComputeLockInputLuma(pos));
+#else
     FFXM_MIN16_F fNucleus = LoadLockInputLuma(pos);
+#endif
 
     FFXM_MIN16_F similar_threshold = FFXM_MIN16_F(1.05f);
     FFXM_MIN16_F dissimilarLumaMin = FFXM_MIN16_F(FSR2_FP16_MAX);
@@ -52,6 +104,21 @@ FfxBoolean ComputeThinFeatureConfidence(FfxInt32x2 pos)
     };
 
     FFXM_MIN16_F lumaSamples [9];
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        lumaSamples[iSample] = FFXM_MIN16_F(gs_LockInputLuma[iTileBase.y + iSample / 3][iTileBase.x + iSample % 3]);
+    }
+#elif FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        const FfxInt32x2 iOffset = FfxInt32x2(iSample % 3, iSample / 3) - FfxInt32x2(1, 1);
+        const FfxInt32x2 iSamplePos = clamp(pos + iOffset, FfxInt32x2(0, 0), FfxInt32x2(RenderSize()) - FfxInt32x2(1, 1));
+        lumaSamples[iSample] = (iSample == 4) ? fNucleus : FFXM_MIN16_F(ComputeLockInputLuma(iSamplePos));
+    }
+#else
     FFXM_MIN16_F fTmpDummy = FFXM_MIN16_F(0.0f);
     const FfxFloat32x2 fInputLumaSize = FfxFloat32x2(RenderSize());
     const FfxFloat32x2 fPxBaseUv = FfxFloat32x2(pos) / fInputLumaSize;
@@ -66,6 +133,7 @@ FfxBoolean ComputeThinFeatureConfidence(FfxInt32x2 pos)
         lumaSamples[7], lumaSamples[8]);
     lumaSamples[2] = LoadLockInputLuma(pos + FfxInt32x2(1, -1));
     lumaSamples[6] = LoadLockInputLuma(pos + FfxInt32x2(-1, 1));
+#endif
 
     FfxInt32 idx = 0;
     FFXM_UNROLL
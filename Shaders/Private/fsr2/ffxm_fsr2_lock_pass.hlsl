@@ -22,6 +22,9 @@
 
 #if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
 #define FSR2_BIND_SRV_DILATED_DEPTH_MOTION_VECTORS_INPUT_LUMA 0
+#elif FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+#define FSR2_BIND_SRV_INPUT_COLOR                           0
+#define FSR2_BIND_SRV_INPUT_EXPOSURE                        2
 #else
 #define FSR2_BIND_SRV_LOCK_INPUT_LUMA                       0
 #endif
@@ -30,11 +33,7 @@
 
 #define FSR2_BIND_CB_FSR2                                   0
 
-#include "ffxm_fsr2_callbacks_hlsl.h"
-#include "ffxm_fsr2_common.h"
-#include "ffxm_fsr2_sample.h"
-#include "ffxm_fsr2_lock.h"
-
+// The group size is also the groupshared tile size, so it is defined before the includes.
 #ifndef FFXM_FSR2_THREAD_GROUP_WIDTH
 #define FFXM_FSR2_THREAD_GROUP_WIDTH 8
 #endif // #ifndef FFXM_FSR2_THREAD_GROUP_WIDTH
@@ -48,12 +47,25 @@
 #define FFXM_FSR2_NUM_THREADS [numthreads(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT, FFXM_FSR2_THREAD_GROUP_DEPTH)]
 #endif // #ifndef FFXM_FSR2_NUM_THREADS
 
+#include "ffxm_fsr2_callbacks_hlsl.h"
+#include "ffxm_fsr2_common.h"
+#include "ffxm_fsr2_sample.h"
+#include "ffxm_fsr2_lock.h"
+
 FFXM_PREFER_WAVE64
 FFXM_FSR2_NUM_THREADS
 FFXM_FSR2_EMBED_ROOTSIG_CONTENT
 void main(uint2 uGroupId : SV_GroupID, uint2 uGroupThreadId : SV_GroupThreadID)
 {
+    // The passes are dispatched over the render size.
+    const uint2 uGroupCount = (uint2(RenderSize()) + uint2(FFXM_FSR2_THREAD_GROUP_WIDTH - 1, FFXM_FSR2_THREAD_GROUP_HEIGHT - 1)) / uint2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT);
+    uGroupId = SwizzleGroupId(uGroupId, uGroupCount, GroupSwizzleWidth());
+
     uint2 uDispatchThreadId = uGroupId * uint2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT) + uGroupThreadId;
 
+#if FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD
+    StageLockTile(uGroupId * uint2(FFXM_FSR2_THREAD_GROUP_WIDTH, FFXM_FSR2_THREAD_GROUP_HEIGHT), uGroupThreadId.y * FFXM_FSR2_THREAD_GROUP_WIDTH + uGroupThreadId.x);
+#endif
+
     ComputeLock(uDispatchThreadId);
 }
@@ -36,11 +36,25 @@ struct RCASOutputs
 #define USE_FSR_RCASH 0
 #endif
 
+/// FFXM_FSR2_OPTION_RCAS_UPSAMPLE. If defined, the input is the reduced-resolution history and is bilinearly resampled to the output pixel centres.
+#ifndef FFXM_FSR2_OPTION_RCAS_UPSAMPLE
+#define FFXM_FSR2_OPTION_RCAS_UPSAMPLE 0
+#endif
+
+FFXM_MIN16_F4 LoadRCASInputColor(FfxInt32x2 p)
+{
+#if FFXM_FSR2_OPTION_RCAS_UPSAMPLE
+    return SampleRCAS_Input((FfxFloat32x2(p) + 0.5f) * RCASUpsampleConfig().xy);
+#else
+    return LoadRCAS_Input(p);
+#endif
+}
+
 #if USE_FSR_RCASH
 #define FSR_RCAS_H 1
 FfxFloat16x4 FsrRcasLoadH(FfxInt16x2 p)
 {
-    FfxFloat16x4 fColor = LoadRCAS_Input(p);
+    FfxFloat16x4 fColor = LoadRCASInputColor(p);
     fColor.rgb = FfxFloat16x3(PrepareRgb(fColor.rgb, Exposure(), PreExposure()));
     return fColor;
 }
@@ -53,7 +67,7 @@ void FsrRcasInputH(inout FfxFloat16 r,inout FfxFloat16 g,inout FfxFloat16 b)
 #define FSR_RCAS_F 1
 FfxFloat32x4 FsrRcasLoadF(FfxInt32x2 p)
 {
-    FfxFloat32x4 fColor = LoadRCAS_Input(p);
+    FfxFloat32x4 fColor = LoadRCASInputColor(p);
 
     fColor.rgb = PrepareRgb(fColor.rgb, Exposure(), PreExposure());
 
@@ -66,6 +80,15 @@ void FsrRcasInputF(inout FfxFloat32 r, inout FfxFloat32 g, inout FfxFloat32 b) {
 
 void CurrFilter(FFXM_MIN16_U2 pos, FFXM_PARAMETER_INOUT RCASOutputs results)
 {
+#if FFXM_FSR2_OPTION_RCAS_UPSAMPLE
+    // Plain bilinear upsample of the history when sharpening is disabled.
+    if (RCASUpsampleConfig().z == 0.0f)
+    {
+        results.fUpscaledColor = LoadRCASInputColor(FfxInt32x2(pos)).rgb;
+        return;
+    }
+#endif
+
 #if USE_FSR_RCASH
     FfxFloat16x3 c;
     FsrRcasH(c.r, c.g, c.b, pos, RCASConfig());
@@ -38,7 +38,9 @@ void ReconstructPrevDepth(FfxInt32x2 iPxPos, FfxFloat32 fDepth, FfxFloat32x2 fMo
     FfxFloat32x2 fUv = (iPxPos + FfxFloat32(0.5)) / iPxDepthSize;
     FfxFloat32x2 fReprojectedUv = fUv + fMotionVector;
 
-    BilinearSamplingData bilinearInfo = GetBilinearSamplingData(fReprojectedUv, RenderSize());
+    // At half resolution the atomics keep the nearest of the depths landing in each 2x2 pixels, so disocclusion stays conservative.
+    const FfxInt32x2 iPrevDepthSize = ReconstructedPrevDepthSize();
+    BilinearSamplingData bilinearInfo = GetBilinearSamplingData(fReprojectedUv, iPrevDepthSize);
 
     // Project current depth into previous frame locations.
     // Push to all pixels having some contribution if reprojection is using bilinear logic.
@@ -50,7 +52,7 @@ void ReconstructPrevDepth(FfxInt32x2 iPxPos, FfxFloat32 fDepth, FfxFloat32x2 fMo
         if (fWeight > fReconstructedDepthBilinearWeightThreshold) {
 
             FfxInt32x2 iStorePos = bilinearInfo.iBasePos + iOffset;
-            if (IsOnScreen(iStorePos, iPxDepthSize)) {
+            if (IsOnScreen(iStorePos, iPrevDepthSize)) {
                 StoreReconstructedDepth(iStorePos, fDepth);
             }
         }
@@ -72,15 +74,38 @@ void FindNearestDepth(FFXM_PARAMETER_IN FfxInt32x2 iPxPos, FFXM_PARAMETER_IN Ffx
         FfxInt32x2(+1, -1),
     };
 
-    // pull out the depth loads to allow SC to batch them
     FfxFloat32 depth[9];
     FfxInt32 iSampleIndex = 0;
+#if FFXM_FSR2_OPTION_GATHER_NEAREST_DEPTH
+    // Each gather at a texel corner returns the 2x2 quad around it, so four of them cover the 3x3 neighborhood.
+    // Samples outside the render size are clamped by the sampler and rejected by IsOnScreen below.
+    const FfxFloat32x2 fInvInputSize = 1.0f / FfxFloat32x2(InputColorResourceDimensions());
+    const FfxFloat32x2 fUv = FfxFloat32x2(iPxPos) * fInvInputSize;
+    FfxFloat32 dMM, d0M, dM0, d00, d1M, d10, dM1, d01, d11, dUnused;
+    GatherInputDepthRQuad(fUv, dMM, d0M, dM0, d00);
+    GatherInputDepthRQuad(fUv + FfxFloat32x2(fInvInputSize.x, 0.0f), dUnused, d1M, dUnused, d10);
+    GatherInputDepthRQuad(fUv + FfxFloat32x2(0.0f, fInvInputSize.y), dUnused, dUnused, dM1, d01);
+    GatherInputDepthRQuad(fUv + fInvInputSize, dUnused, dUnused, dUnused, d11);
+
+    // Same order as iSampleOffsets.
+    depth[0] = d00;
+    depth[1] = d10;
+    depth[2] = d01;
+    depth[3] = d0M;
+    depth[4] = dM0;
+    depth[5] = dM1;
+    depth[6] = d11;
+    depth[7] = dMM;
+    depth[8] = d1M;
+#else
+    // pull out the depth loads to allow SC to batch them
     FFXM_UNROLL
     for (iSampleIndex = 0; iSampleIndex < iSampleCount; ++iSampleIndex) {
 
         FfxInt32x2 iPos = iPxPos + iSampleOffsets[iSampleIndex];
         depth[iSampleIndex] = LoadInputDepth(iPos);
     }
+#endif
 
     // find closest depth
     fNearestDepthCoord = iPxPos;
@@ -50,8 +50,10 @@ struct ReconstructPrevDepthOutputsFS
 #else
     FfxFloat32 fDepth           : SV_TARGET0;
     FfxFloat32x2 fMotionVector  : SV_TARGET1;
+#if !FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
     FfxFloat32 fLuma            : SV_TARGET2;
 #endif
+#endif
 };
 
 
@@ -65,7 +67,10 @@ ReconstructPrevDepthOutputsFS main(float4 SvPosition : SV_POSITION)
 #else
     output.fDepth = result.fDepth;
     output.fMotionVector = result.fMotionVector;
+#if !FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+    // Lock recomputes the luma from the input colour otherwise.
     output.fLuma = result.fLuma;
+#endif
 #endif
     return output;
 }
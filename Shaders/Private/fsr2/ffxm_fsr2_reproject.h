@@ -44,7 +44,73 @@ FfxFloat32x4 SampleHistory(FfxFloat32x2 fUV)
 #endif
 
 
-#if FFXM_HALF
+#if FFXM_FSR2_OPTION_REPROJECT_LANCZOS_BILINEAR
+// Lanczos2 weights on the 4x4 texel footprint. The two centre taps of each axis have positive weights, so like the
+// Catmull-Rom 9-tap kernel they are merged into a single bilinear fetch, which leaves 9 fetches instead of 16.
+void GetLanczos2BilinearAxis(FfxFloat32 fPos, FfxFloat32 fInvSize, FFXM_PARAMETER_OUT FfxFloat32 fUV[3], FFXM_PARAMETER_OUT FfxFloat32 fWeight[3])
+{
+    const FfxFloat32 fTexPos1 = floor(fPos - 0.5f) + 0.5f;
+    const FfxFloat32 f = fPos - fTexPos1;
+
+#if FFXM_FSR2_OPTION_LANCZOS_LUT
+    const FfxFloat32 w0 = SampleLanczos2WeightSq((1.0f + f) * (1.0f + f));
+    const FfxFloat32 w1 = SampleLanczos2WeightSq(f * f);
+    const FfxFloat32 w2 = SampleLanczos2WeightSq((1.0f - f) * (1.0f - f));
+    const FfxFloat32 w3 = SampleLanczos2WeightSq((2.0f - f) * (2.0f - f));
+#else
+    const FfxFloat32 w0 = Lanczos2ApproxSq((1.0f + f) * (1.0f + f));
+    const FfxFloat32 w1 = Lanczos2ApproxSq(f * f);
+    const FfxFloat32 w2 = Lanczos2ApproxSq((1.0f - f) * (1.0f - f));
+    const FfxFloat32 w3 = Lanczos2ApproxSq((2.0f - f) * (2.0f - f));
+#endif
+    const FfxFloat32 fRcpWeightSum = 1.0f / (w0 + w1 + w2 + w3);
+
+    fUV[0] = (fTexPos1 - 1.0f) * fInvSize;
+    fUV[1] = (fTexPos1 + w2 / (w1 + w2)) * fInvSize;
+    fUV[2] = (fTexPos1 + 2.0f) * fInvSize;
+
+    fWeight[0] = w0 * fRcpWeightSum;
+    fWeight[1] = (w1 + w2) * fRcpWeightSum;
+    fWeight[2] = w3 * fRcpWeightSum;
+}
+
+FFXM_MIN16_F4 HistorySample(FfxFloat32x2 fUvSample, FfxInt32x2 iTextureSize)
+{
+    const FfxFloat32x2 fTextureSize = FfxFloat32x2(iTextureSize);
+    const FfxFloat32x2 fInvTextureSize = FfxFloat32x2(1.0f, 1.0f) / fTextureSize;
+    const FfxFloat32x2 fSamplePos = fUvSample * fTextureSize;
+
+    FfxFloat32 fUVX[3], fUVY[3], fWeightX[3], fWeightY[3];
+    GetLanczos2BilinearAxis(fSamplePos.x, fInvTextureSize.x, fUVX, fWeightX);
+    GetLanczos2BilinearAxis(fSamplePos.y, fInvTextureSize.y, fUVY, fWeightY);
+
+    FFXM_MIN16_F4 fColor = FFXM_MIN16_F4(0.0f, 0.0f, 0.0f, 0.0f);
+    FFXM_MIN16_F4 fDeringingMin = FFXM_MIN16_F4(0.0f, 0.0f, 0.0f, 0.0f);
+    FFXM_MIN16_F4 fDeringingMax = FFXM_MIN16_F4(0.0f, 0.0f, 0.0f, 0.0f);
+
+    FFXM_UNROLL
+    for (FfxInt32 y = 0; y < 3; y++)
+    {
+        FFXM_UNROLL
+        for (FfxInt32 x = 0; x < 3; x++)
+        {
+            const FFXM_MIN16_F4 fSample = FFXM_MIN16_F4(SampleHistory(FfxFloat32x2(fUVX[x], fUVY[y])));
+            fColor += fSample * FFXM_MIN16_F(fWeightX[x] * fWeightY[y]);
+
+            // Deringing bounds come from the centre fetch and its 4 direct neighbours, which cover the nearest texels.
+            if (x == 1 || y == 1)
+            {
+                const FfxBoolean bInitialSample = (x == 1) && (y == 0);
+                fDeringingMin = bInitialSample ? fSample : ffxMin(fDeringingMin, fSample);
+                fDeringingMax = bInitialSample ? fSample : ffxMax(fDeringingMax, fSample);
+            }
+        }
+    }
+
+    return clamp(fColor, fDeringingMin, fDeringingMax);
+}
+
+#elif FFXM_HALF
 
 #define FFXM_FSR2_REPROJECT_CATMULL_9TAP 0
 #define FFXM_FSR2_REPROJECT_LANCZOS_APPROX_9TAP 1
@@ -317,6 +383,10 @@ void ComputeReprojectedUVs(const AccumulationPassCommonParams params, FFXM_PARAM
 void ReprojectHistoryColor(const AccumulationPassCommonParams params, FFXM_PARAMETER_OUT FfxFloat32x3 fHistoryColor, FFXM_PARAMETER_OUT FfxFloat32 fTemporalReactiveFactor, FFXM_PARAMETER_OUT FfxBoolean bInMotionLastFrame)
 {
     FfxFloat32x4 fHistory = HistorySample(params.fReprojectedHrUv, DisplaySize());
+#if FFXM_FSR2_OPTION_COMPACT_HISTORY
+    // The compact history has no alpha, the signed temporal reactive factor is stored separately.
+    fHistory.w = SampleTemporalReactive(params.fReprojectedHrUv);
+#endif
 
     fHistoryColor = PrepareRgb(fHistory.rgb, Exposure(), PreviousFramePreExposure());
 
@@ -350,6 +420,10 @@ LockState ReprojectHistoryLockStatus(const AccumulationPassCommonParams params,
 void ReprojectHistoryColor(const AccumulationPassCommonParams params, FFXM_PARAMETER_OUT FfxFloat16x3 fHistoryColor, FFXM_PARAMETER_OUT FfxFloat16 fTemporalReactiveFactor, FFXM_PARAMETER_OUT FfxBoolean bInMotionLastFrame)
 {
     FfxFloat16x4 fHistory = HistorySample(params.fReprojectedHrUv, DisplaySize());
+#if FFXM_FSR2_OPTION_COMPACT_HISTORY
+    // The compact history has no alpha, the signed temporal reactive factor is stored separately.
+    fHistory.w = FfxFloat16(SampleTemporalReactive(params.fReprojectedHrUv));
+#endif
 
     fHistoryColor = FfxFloat16x3(PrepareRgb(fHistory.rgb, Exposure(), PreviousFramePreExposure()));
 
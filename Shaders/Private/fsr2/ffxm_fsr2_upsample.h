@@ -49,7 +49,11 @@ void Deringing(RectificationBoxMin16 clippingBox, FFXM_PARAMETER_INOUT FFXM_MIN1
 FfxFloat32 GetUpsampleLanczosWeight(FfxFloat32x2 fSrcSampleOffset, FfxFloat32 fKernelWeight)
 {
     FfxFloat32x2 fSrcSampleOffsetBiased = fSrcSampleOffset * fKernelWeight.xx;
+#if FFXM_FSR2_OPTION_LANCZOS_LUT
+    FfxFloat32 fSampleWeight = SampleLanczos2WeightSq(dot(fSrcSampleOffsetBiased, fSrcSampleOffsetBiased));
+#else
     FfxFloat32 fSampleWeight = Lanczos2ApproxSq(dot(fSrcSampleOffsetBiased, fSrcSampleOffsetBiased));
+#endif
     return fSampleWeight;
 }
 
@@ -57,7 +61,11 @@ FfxFloat32 GetUpsampleLanczosWeight(FfxFloat32x2 fSrcSampleOffset, FfxFloat32 fK
 FFXM_MIN16_F GetUpsampleLanczosWeight(FFXM_MIN16_F2 fSrcSampleOffset, FFXM_MIN16_F fKernelWeight)
 {
     FFXM_MIN16_F2 fSrcSampleOffsetBiased = fSrcSampleOffset * fKernelWeight.xx;
+#if FFXM_FSR2_OPTION_LANCZOS_LUT
+    FFXM_MIN16_F fSampleWeight = FFXM_MIN16_F(SampleLanczos2WeightSq(FfxFloat32(dot(fSrcSampleOffsetBiased, fSrcSampleOffsetBiased))));
+#else
     FFXM_MIN16_F fSampleWeight = Lanczos2ApproxSq(dot(fSrcSampleOffsetBiased, fSrcSampleOffsetBiased));
+#endif
     return fSampleWeight;
 }
 #endif
@@ -70,7 +78,45 @@ FfxFloat32 ComputeMaxKernelWeight() {
     return ffxMin(FfxFloat32(1.99f), fKernelWeight);
 }
 
-#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#if FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE
+// 3x3 Lanczos weights, row-major from offset (-1, -1). The table holds 3 entries per output pixel phase for each jitter
+// phase, built on the CPU for the widest kernel. Pixels that narrow the kernel evaluate their weights instead.
+void GetUpsampleWeights(FfxInt32x2 iPxHrPos, FFXM_MIN16_F2 fBaseSampleOffset, FFXM_MIN16_F fKernelBias, FfxBoolean bUseWeightTable,
+    FFXM_PARAMETER_OUT FFXM_MIN16_F fWeights[9])
+{
+    FFXM_BRANCH
+    if (bUseWeightTable)
+    {
+        const FfxInt32x2 iPhase = iPxHrPos % FFXM_FSR2_UPSCALE_RATIO_PERIOD;
+        const FfxInt32 iIndex = ((FfxInt32(JitterPhaseIndex()) * FFXM_FSR2_UPSCALE_RATIO_PERIOD + iPhase.y) * FFXM_FSR2_UPSCALE_RATIO_PERIOD + iPhase.x) * 3;
+        const FFXM_MIN16_F4 fWeights0 = LoadUpsampleWeights(iIndex);
+        const FFXM_MIN16_F4 fWeights1 = LoadUpsampleWeights(iIndex + 1);
+        const FFXM_MIN16_F fWeights2 = LoadUpsampleWeights(iIndex + 2).x;
+        fWeights[0] = fWeights0.x; fWeights[1] = fWeights0.y; fWeights[2] = fWeights0.z;
+        fWeights[3] = fWeights0.w; fWeights[4] = fWeights1.x; fWeights[5] = fWeights1.y;
+        fWeights[6] = fWeights1.z; fWeights[7] = fWeights1.w; fWeights[8] = fWeights2;
+    }
+    else
+    {
+        FFXM_UNROLL
+        for (FfxInt32 iTap = 0; iTap < 9; iTap++)
+        {
+            const FFXM_MIN16_F2 fOffset = FFXM_MIN16_F2(iTap % 3 - 1, iTap / 3 - 1);
+#if FFXM_FSR2_UPSAMPLE_KERNEL == FFXM_FSR2_UPSAMPLE_USE_LANCZOS_5_TAP || FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+            // The cross kernel skips the corners.
+            if ((iTap & 1) == 0 && iTap != 4)
+            {
+                fWeights[iTap] = FFXM_MIN16_F(0);
+                continue;
+            }
+#endif
+            fWeights[iTap] = FFXM_MIN16_F(GetUpsampleLanczosWeight(fBaseSampleOffset + fOffset, fKernelBias));
+        }
+    }
+}
+#endif
+
+#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE || FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
 FfxFloat32x3 ComputePreparedInputColor(FfxInt32x2 iPxLrPos)
 {
     //We assume linear data. if non-linear input (sRGB, ...),
@@ -126,9 +172,24 @@ FfxFloat32x4 ComputeUpsampledColorAndWeight(const AccumulationPassCommonParams p
 
     FFXM_MIN16_F2 fOffsetTL = offsetTL;
 
+#if FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE
+    // The table only covers the widest kernel, so not pixels that are reactive, depth clipped or new.
+    FFXM_MIN16_F fTapWeights[9];
+    const FfxBoolean bUseWeightTable = (fKernelBiasFactor == FFXM_MIN16_F(0));
+    GetUpsampleWeights(params.iPxHrPos, fBaseSampleOffset, fKernelBias, bUseWeightTable, fTapWeights);
+#endif
+
 #if FFXM_FSR2_UPSAMPLE_KERNEL == FFXM_FSR2_UPSAMPLE_USE_LANCZOS_9_TAP && !FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
     FFXM_MIN16_F3 fSamples[iLanczos2SampleCount];
     // Collect samples
+#if FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
+    FFXM_UNROLL
+    for (FfxInt32 iSample = 0; iSample < 9; iSample++)
+    {
+        const FfxInt32x2 iOffset = FfxInt32x2(iSample % 3, iSample / 3) - FfxInt32x2(1, 1);
+        fSamples[(iSample % 3) + ((iSample / 3) << 2)] = FFXM_MIN16_F3(ComputePreparedInputColor(iOffset + iSrcInputPos));
+    }
+#else
     GatherPreparedInputColorRGBQuad(FfxFloat32x2(-0.5, -0.5) * unitOffsetUv + iSrcInputUv,
         fSamples[0], fSamples[1], fSamples[4], fSamples[5]);
     fSamples[2] =  LoadPreparedInputColor(FfxInt32x2(1, -1) + iSrcInputPos);
@@ -136,6 +197,7 @@ FfxFloat32x4 ComputeUpsampledColorAndWeight(const AccumulationPassCommonParams p
     fSamples[8] =  LoadPreparedInputColor(FfxInt32x2(-1, 1) + iSrcInputPos);
     fSamples[9] =  LoadPreparedInputColor(FfxInt32x2(0, 1)  + iSrcInputPos);
     fSamples[10] = LoadPreparedInputColor(FfxInt32x2(1, 1)  + iSrcInputPos);
+#endif
 
     FFXM_UNROLL
     for (FfxInt32 row = 0; row < 3; row++)
@@ -149,7 +211,11 @@ FfxFloat32x4 ComputeUpsampledColorAndWeight(const AccumulationPassCommonParams p
             FFXM_MIN16_F2 fSrcSampleOffset = fBaseSampleOffset + fOffset;
 
             FfxInt32x2 iSrcSamplePos = FfxInt32x2(iSrcInputPos) + FfxInt32x2(offsetTL) + sampleColRow;
+#if FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE
+            FFXM_MIN16_F fSampleWeight = fTapWeights[row * 3 + col];
+#else
             FFXM_MIN16_F fSampleWeight = FFXM_MIN16_F(GetUpsampleLanczosWeight(fSrcSampleOffset, fKernelBias));
+#endif
 
             fColorAndWeight += FFXM_MIN16_F4(fSamples[iSampleIndex] * fSampleWeight, fSampleWeight);
 
@@ -168,7 +234,7 @@ FfxFloat32x4 ComputeUpsampledColorAndWeight(const AccumulationPassCommonParams p
     FFXM_MIN16_F3 fSamples[iLanczos2SampleCount];
     // Collect samples
     FfxInt32x2 rowCol [iLanczos2SampleCount] = {FfxInt32x2(0, -1), FfxInt32x2(-1, 0), FfxInt32x2(0, 0), FfxInt32x2(1, 0), FfxInt32x2(0, 1)};
-#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE
+#if FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE || FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS
     fSamples[0] = ComputePreparedInputColor(rowCol[0] + iSrcInputPos);
     fSamples[1] = ComputePreparedInputColor(rowCol[1] + iSrcInputPos);
     fSamples[2] = ComputePreparedInputColor(rowCol[2] + iSrcInputPos);
@@ -189,7 +255,11 @@ FfxFloat32x4 ComputeUpsampledColorAndWeight(const AccumulationPassCommonParams p
         FFXM_MIN16_F2 fSrcSampleOffset = fBaseSampleOffset + fOffset;
 
         FfxInt32x2 iSrcSamplePos = FfxInt32x2(iSrcInputPos) + FfxInt32x2(offsetTL) + sampleColRow;
+#if FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE
+        FFXM_MIN16_F fSampleWeight = fTapWeights[(sampleColRow.y + 1) * 3 + sampleColRow.x + 1];
+#else
         FFXM_MIN16_F fSampleWeight = FFXM_MIN16_F(GetUpsampleLanczosWeight(fSrcSampleOffset, fKernelBias));
+#endif
 
         fColorAndWeight += FFXM_MIN16_F4(fSamples[idx] * fSampleWeight, fSampleWeight);
 
@@ -205,6 +275,8 @@ FfxFloat32x4 ComputeUpsampledColorAndWeight(const AccumulationPassCommonParams p
 
 #endif
 
+    // The box is built from the samples the Lanczos kernel gathers anyway. Precomputing it in Depth Clip would not save
+    // any fetches here.
     RectificationBoxComputeVarianceBoxData(clippingBox);
 
     fColorAndWeight.w *= FFXM_MIN16_F(fColorAndWeight.w > FSR2_EPSILON);
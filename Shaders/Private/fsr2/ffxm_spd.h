@@ -123,6 +123,16 @@ FfxFloat32x4 SpdReduce4(FfxFloat32x4 v0, FfxFloat32x4 v1, FfxFloat32x4 v2, FfxFl
 #extension GL_KHR_shader_subgroup_quad:require
 #endif
 
+/// FFXM_SPD_SUBGROUP_REDUCTION. 0, 8 or 16, the minimum number of lanes of the device's subgroups. Requires
+/// FFXM_SPD_WAVE_OPERATIONS and subgroups filled in thread order, so that the lane of each thread is its
+/// localInvocationIndex % WaveSize. If not 0, the third and fifth mip of each SpdDownsampleNextFour are reduced from the
+/// second and fourth with subgroup shuffles. With 16 lanes this halves its group barriers and skips the groupshared round
+/// trips of the mips in between. With 8 lanes a single shuffle combines two quads and only one pair of groupshared stores
+/// is left for the other two.
+#if defined(FFXM_GLSL) && FFXM_SPD_WAVE_OPERATIONS && FFXM_SPD_SUBGROUP_REDUCTION
+#extension GL_KHR_shader_subgroup_shuffle:require
+#endif
+
 void ffxSpdWorkgroupShuffleBarrier()
 {
     FFXM_GROUP_MEMORY_BARRIER();
@@ -187,6 +197,38 @@ FfxFloat32x4 SpdReduceQuad(FfxFloat32x4 v)
     return v;
 }
 
+#if FFXM_SPD_WAVE_OPERATIONS && FFXM_SPD_SUBGROUP_REDUCTION
+// ffxRemapForWaveReduction lays each run of 16 threads out as a 4x4 block, with its quads starting at lanes 0, 4, 8 and 12.
+// Lanes 0-7 are the left 2x4 half of the block and lanes 8-15 the right one, lane ^ 4 is the other quad of the same half.
+// Both shuffles rely on the lane of each thread being its localInvocationIndex % WaveSize.
+#if FFXM_SPD_SUBGROUP_REDUCTION >= 16
+FfxFloat32x4 SpdReduceSubgroup16(FfxFloat32x4 v)
+{
+#if defined(FFXM_GLSL)
+    FfxFloat32x4 v1 = subgroupShuffleXor(v, 4u);
+    FfxFloat32x4 v2 = subgroupShuffleXor(v, 8u);
+    FfxFloat32x4 v3 = subgroupShuffleXor(v, 12u);
+#else
+    FfxUInt32 lane  = WaveGetLaneIndex();
+    FfxFloat32x4 v1 = WaveReadLaneAt(v, lane ^ 4u);
+    FfxFloat32x4 v2 = WaveReadLaneAt(v, lane ^ 8u);
+    FfxFloat32x4 v3 = WaveReadLaneAt(v, lane ^ 12u);
+#endif
+    return SpdReduce4(v, v1, v2, v3);
+}
+#else
+// Returns v of the quad two rows below (or above) in the same 2x4 half of the block.
+FfxFloat32x4 SpdReadSubgroupVerticalQuad(FfxFloat32x4 v)
+{
+#if defined(FFXM_GLSL)
+    return subgroupShuffleXor(v, 4u);
+#else
+    return WaveReadLaneAt(v, WaveGetLaneIndex() ^ 4u);
+#endif
+}
+#endif
+#endif
+
 FfxFloat32x4 SpdReduceIntermediate(FfxUInt32x2 i0, FfxUInt32x2 i1, FfxUInt32x2 i2, FfxUInt32x2 i3)
 {
     FfxFloat32x4 v0 = SpdLoadIntermediate(i0.x, i0.y);
@@ -491,11 +533,112 @@ void SpdDownsampleMips_6_7(FfxUInt32 x, FfxUInt32 y, FfxUInt32 mips, FfxUInt32 s
     SpdStoreIntermediate(x, y, v);
 }
 
+#if FFXM_SPD_WAVE_OPERATIONS && FFXM_SPD_SUBGROUP_REDUCTION
+void SpdDownsampleMips_2_3_Subgroup(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, FfxUInt32 localInvocationIndex, FfxUInt32 mip, FfxUInt32 mips, FfxUInt32 slice)
+{
+    FfxFloat32x4 v = SpdReduceQuad(SpdLoadIntermediate(x, y));
+    // quad index 0 stores result
+    if (localInvocationIndex % 4 == 0)
+    {
+        SpdStore(FfxInt32x2(workGroupID.xy * 8) + FfxInt32x2(x / 2, y / 2), v, mip, slice);
+    }
+
+    if (mips <= mip + 1)
+        return;
+#if FFXM_SPD_SUBGROUP_REDUCTION >= 16
+    // the four quads of a 4x4 block are in the same subgroup, no barrier needed
+    v = SpdReduceSubgroup16(v);
+#else
+    // each 2x4 half of a 4x4 block is in one subgroup, the right half hands its two quads to the left one through
+    // groupshared memory, at texels that only its own threads have read
+    FfxFloat32x4 vBelow = SpdReadSubgroupVerticalQuad(v);
+    if (localInvocationIndex % 4 == 0 && (localInvocationIndex & 8u) != 0)
+    {
+        SpdStoreIntermediate(x, y, v);
+    }
+    ffxSpdWorkgroupShuffleBarrier();
+    if (localInvocationIndex % 16 == 0)
+    {
+        v = SpdReduce4(v, vBelow, SpdLoadIntermediate(x + 2, y), SpdLoadIntermediate(x + 2, y + 2));
+    }
+#endif
+    if (localInvocationIndex % 16 == 0)
+    {
+        SpdStore(FfxInt32x2(workGroupID.xy * 4) + FfxInt32x2(x / 4, y / 4), v, mip + 1, slice);
+        // same layout as SpdDownsampleMip_3, inside the texels this block has already read
+        SpdStoreIntermediate(x + y / 4, y, v);
+    }
+}
+
+void SpdDownsampleMips_4_5_Subgroup(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, FfxUInt32 localInvocationIndex, FfxUInt32 mip, FfxUInt32 mips, FfxUInt32 slice)
+{
+#if FFXM_SPD_SUBGROUP_REDUCTION >= 16
+    if (localInvocationIndex < 16)
+    {
+        FfxFloat32x4 v = SpdReduceQuad(SpdLoadIntermediate(x * 4 + y, y * 4));
+        // quad index 0 stores result
+        if (localInvocationIndex % 4 == 0)
+        {
+            SpdStore(FfxInt32x2(workGroupID.xy * 2) + FfxInt32x2(x / 2, y / 2), v, mip, slice);
+        }
+
+        if (mips > mip + 1)
+        {
+            v = SpdReduceSubgroup16(v);
+            if (localInvocationIndex == 0)
+            {
+                SpdStore(FfxInt32x2(workGroupID.xy), v, mip + 1, slice);
+            }
+        }
+    }
+#else
+    FfxFloat32x4 v = FfxFloat32x4(0.0, 0.0, 0.0, 0.0);
+    FfxFloat32x4 vBelow = v;
+    if (localInvocationIndex < 16)
+    {
+        v = SpdReduceQuad(SpdLoadIntermediate(x * 4 + y, y * 4));
+        // quad index 0 stores result
+        if (localInvocationIndex % 4 == 0)
+        {
+            SpdStore(FfxInt32x2(workGroupID.xy * 2) + FfxInt32x2(x / 2, y / 2), v, mip, slice);
+        }
+
+        if (mips > mip + 1)
+        {
+            // same exchange as SpdDownsampleMips_2_3_Subgroup
+            vBelow = SpdReadSubgroupVerticalQuad(v);
+            if (localInvocationIndex % 4 == 0 && (localInvocationIndex & 8u) != 0)
+            {
+                SpdStoreIntermediate(x * 4 + y, y * 4, v);
+            }
+        }
+    }
+
+    if (mips <= mip + 1)
+        return;
+    ffxSpdWorkgroupShuffleBarrier();
+    if (localInvocationIndex == 0)
+    {
+        v = SpdReduce4(v, vBelow, SpdLoadIntermediate((x + 2) * 4 + y, y * 4), SpdLoadIntermediate((x + 2) * 4 + y + 2, (y + 2) * 4));
+        SpdStore(FfxInt32x2(workGroupID.xy), v, mip + 1, slice);
+    }
+#endif
+}
+#endif
+
 void SpdDownsampleNextFour(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, FfxUInt32 localInvocationIndex, FfxUInt32 baseMip, FfxUInt32 mips, FfxUInt32 slice)
 {
     if (mips <= baseMip)
         return;
     ffxSpdWorkgroupShuffleBarrier();
+#if FFXM_SPD_WAVE_OPERATIONS && FFXM_SPD_SUBGROUP_REDUCTION
+    SpdDownsampleMips_2_3_Subgroup(x, y, workGroupID, localInvocationIndex, baseMip, mips, slice);
+
+    if (mips <= baseMip + 2)
+        return;
+    ffxSpdWorkgroupShuffleBarrier();
+    SpdDownsampleMips_4_5_Subgroup(x, y, workGroupID, localInvocationIndex, baseMip + 2, mips, slice);
+#else
     SpdDownsampleMip_2(x, y, workGroupID, localInvocationIndex, baseMip, slice);
 
     if (mips <= baseMip + 1)
@@ -512,6 +655,7 @@ void SpdDownsampleNextFour(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, Ff
         return;
     ffxSpdWorkgroupShuffleBarrier();
     SpdDownsampleMip_5(workGroupID, localInvocationIndex, baseMip + 3, slice);
+#endif
 }
 
 /// Downsamples a 64x64 tile based on the work group id.
@@ -624,6 +768,34 @@ FfxFloat16x4 SpdReduceQuadH(FfxFloat16x4 v)
     return FfxFloat16x4(0.0, 0.0, 0.0, 0.0);
 }
 
+#if FFXM_SPD_WAVE_OPERATIONS && FFXM_SPD_SUBGROUP_REDUCTION
+#if FFXM_SPD_SUBGROUP_REDUCTION >= 16
+FfxFloat16x4 SpdReduceSubgroup16H(FfxFloat16x4 v)
+{
+#if defined(FFXM_GLSL)
+    FfxFloat16x4 v1 = subgroupShuffleXor(v, 4u);
+    FfxFloat16x4 v2 = subgroupShuffleXor(v, 8u);
+    FfxFloat16x4 v3 = subgroupShuffleXor(v, 12u);
+#else
+    FfxUInt32 lane  = WaveGetLaneIndex();
+    FfxFloat16x4 v1 = WaveReadLaneAt(v, lane ^ 4u);
+    FfxFloat16x4 v2 = WaveReadLaneAt(v, lane ^ 8u);
+    FfxFloat16x4 v3 = WaveReadLaneAt(v, lane ^ 12u);
+#endif
+    return SpdReduce4H(v, v1, v2, v3);
+}
+#else
+FfxFloat16x4 SpdReadSubgroupVerticalQuadH(FfxFloat16x4 v)
+{
+#if defined(FFXM_GLSL)
+    return subgroupShuffleXor(v, 4u);
+#else
+    return WaveReadLaneAt(v, WaveGetLaneIndex() ^ 4u);
+#endif
+}
+#endif
+#endif
+
 FfxFloat16x4 SpdReduceIntermediateH(FfxUInt32x2 i0, FfxUInt32x2 i1, FfxUInt32x2 i2, FfxUInt32x2 i3)
 {
     FfxFloat16x4 v0 = SpdLoadIntermediateH(i0.x, i0.y);
@@ -928,11 +1100,112 @@ void SpdDownsampleMips_6_7H(FfxUInt32 x, FfxUInt32 y, FfxUInt32 mips, FfxUInt32
     SpdStoreIntermediateH(x, y, v);
 }
 
+#if FFXM_SPD_WAVE_OPERATIONS && FFXM_SPD_SUBGROUP_REDUCTION
+void SpdDownsampleMips_2_3_SubgroupH(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, FfxUInt32 localInvocationIndex, FfxUInt32 mip, FfxUInt32 mips, FfxUInt32 slice)
+{
+    FfxFloat16x4 v = SpdReduceQuadH(SpdLoadIntermediateH(x, y));
+    // quad index 0 stores result
+    if (localInvocationIndex % 4 == 0)
+    {
+        SpdStoreH(FfxInt32x2(workGroupID.xy * 8) + FfxInt32x2(x / 2, y / 2), v, mip, slice);
+    }
+
+    if (mips <= mip + 1)
+        return;
+#if FFXM_SPD_SUBGROUP_REDUCTION >= 16
+    // the four quads of a 4x4 block are in the same subgroup, no barrier needed
+    v = SpdReduceSubgroup16H(v);
+#else
+    // each 2x4 half of a 4x4 block is in one subgroup, the right half hands its two quads to the left one through
+    // groupshared memory, at texels that only its own threads have read
+    FfxFloat16x4 vBelow = SpdReadSubgroupVerticalQuadH(v);
+    if (localInvocationIndex % 4 == 0 && (localInvocationIndex & 8u) != 0)
+    {
+        SpdStoreIntermediateH(x, y, v);
+    }
+    ffxSpdWorkgroupShuffleBarrier();
+    if (localInvocationIndex % 16 == 0)
+    {
+        v = SpdReduce4H(v, vBelow, SpdLoadIntermediateH(x + 2, y), SpdLoadIntermediateH(x + 2, y + 2));
+    }
+#endif
+    if (localInvocationIndex % 16 == 0)
+    {
+        SpdStoreH(FfxInt32x2(workGroupID.xy * 4) + FfxInt32x2(x / 4, y / 4), v, mip + 1, slice);
+        // same layout as SpdDownsampleMip_3H, inside the texels this block has already read
+        SpdStoreIntermediateH(x + y / 4, y, v);
+    }
+}
+
+void SpdDownsampleMips_4_5_SubgroupH(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, FfxUInt32 localInvocationIndex, FfxUInt32 mip, FfxUInt32 mips, FfxUInt32 slice)
+{
+#if FFXM_SPD_SUBGROUP_REDUCTION >= 16
+    if (localInvocationIndex < 16)
+    {
+        FfxFloat16x4 v = SpdReduceQuadH(SpdLoadIntermediateH(x * 4 + y, y * 4));
+        // quad index 0 stores result
+        if (localInvocationIndex % 4 == 0)
+        {
+            SpdStoreH(FfxInt32x2(workGroupID.xy * 2) + FfxInt32x2(x / 2, y / 2), v, mip, slice);
+        }
+
+        if (mips > mip + 1)
+        {
+            v = SpdReduceSubgroup16H(v);
+            if (localInvocationIndex == 0)
+            {
+                SpdStoreH(FfxInt32x2(workGroupID.xy), v, mip + 1, slice);
+            }
+        }
+    }
+#else
+    FfxFloat16x4 v = FfxFloat16x4(0.0, 0.0, 0.0, 0.0);
+    FfxFloat16x4 vBelow = v;
+    if (localInvocationIndex < 16)
+    {
+        v = SpdReduceQuadH(SpdLoadIntermediateH(x * 4 + y, y * 4));
+        // quad index 0 stores result
+        if (localInvocationIndex % 4 == 0)
+        {
+            SpdStoreH(FfxInt32x2(workGroupID.xy * 2) + FfxInt32x2(x / 2, y / 2), v, mip, slice);
+        }
+
+        if (mips > mip + 1)
+        {
+            // same exchange as SpdDownsampleMips_2_3_SubgroupH
+            vBelow = SpdReadSubgroupVerticalQuadH(v);
+            if (localInvocationIndex % 4 == 0 && (localInvocationIndex & 8u) != 0)
+            {
+                SpdStoreIntermediateH(x * 4 + y, y * 4, v);
+            }
+        }
+    }
+
+    if (mips <= mip + 1)
+        return;
+    ffxSpdWorkgroupShuffleBarrier();
+    if (localInvocationIndex == 0)
+    {
+        v = SpdReduce4H(v, vBelow, SpdLoadIntermediateH((x + 2) * 4 + y, y * 4), SpdLoadIntermediateH((x + 2) * 4 + y + 2, (y + 2) * 4));
+        SpdStoreH(FfxInt32x2(workGroupID.xy), v, mip + 1, slice);
+    }
+#endif
+}
+#endif
+
 void SpdDownsampleNextFourH(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, FfxUInt32 localInvocationIndex, FfxUInt32 baseMip, FfxUInt32 mips, FfxUInt32 slice)
 {
     if (mips <= baseMip)
         return;
     ffxSpdWorkgroupShuffleBarrier();
+#if FFXM_SPD_WAVE_OPERATIONS && FFXM_SPD_SUBGROUP_REDUCTION
+    SpdDownsampleMips_2_3_SubgroupH(x, y, workGroupID, localInvocationIndex, baseMip, mips, slice);
+
+    if (mips <= baseMip + 2)
+        return;
+    ffxSpdWorkgroupShuffleBarrier();
+    SpdDownsampleMips_4_5_SubgroupH(x, y, workGroupID, localInvocationIndex, baseMip + 2, mips, slice);
+#else
     SpdDownsampleMip_2H(x, y, workGroupID, localInvocationIndex, baseMip, slice);
 
     if (mips <= baseMip + 1)
@@ -949,6 +1222,7 @@ void SpdDownsampleNextFourH(FfxUInt32 x, FfxUInt32 y, FfxUInt32x2 workGroupID, F
         return;
     ffxSpdWorkgroupShuffleBarrier();
     SpdDownsampleMip_5H(workGroupID, localInvocationIndex, baseMip + 3, slice);
+#endif
 }
 
 /// Downsamples a 64x64 tile based on the work group id and work group offset.
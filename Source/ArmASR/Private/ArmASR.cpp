@@ -9,6 +9,8 @@
 #include "TemporalUpscaler.h"
 #include "ArmASRPassthroughDenoiser.h"
 #include "ArmASRSettings.h"
+#include "Async/Async.h"
+#include "Misc/ConfigCacheIni.h"
 
 #define ARM_ASR_ENABLE_VK 1
 
@@ -50,6 +52,138 @@ TAutoConsoleVariable<int32> CVarArmASRShaderQuality(
 	TEXT("Select shader quality preset. 1: Quality / 2: Balanced / 3: Performance / 4: Ultra Performance"),
 	ECVF_RenderThreadSafe);
 
+TAutoConsoleVariable<int32> CVarArmASRExperimentalShaderPermutations(
+	TEXT("r.ArmASR.ExperimentalShaderPermutations"),
+	0,
+	TEXT("Read only, set it in the project's DefaultEngine.ini [SystemSettings] section before cooking. Compile the shader permutations of the experimental options: r.ArmASR.HistoryEncoding, r.ArmASR.RenderResolutionAuxHistory, r.ArmASR.LumaHistoryMoments, r.ArmASR.LanczosReprojection, r.ArmASR.RatioSpecializedShaders, r.ArmASR.UpsampleWeightTable, r.ArmASR.LanczosLut, r.ArmASR.RecomputePreparedInputs, r.ArmASR.PartialLumaPyramid, r.ArmASR.FusedLumaMip, r.ArmASR.GatherNearestDepth, r.ArmASR.EpochTaggedPrevDepth, r.ArmASR.HalfResPrevDepth and r.ArmASR.GroupsharedNeighborhood. Those options are ignored when it is 0. Default is 0."),
+	ECVF_ReadOnly);
+
+TAutoConsoleVariable<int32> CVarArmASRHistoryEncoding(
+	TEXT("r.ArmASR.HistoryEncoding"),
+	0,
+	TEXT("Quality preset only. Select the encoding of the upscaled colour history. 0: R16G16B16A16_Float with the temporal reactive factor in alpha / 1: R11G11B10_Float with the temporal reactive factor in a separate R16_Float texture, as used by Balanced and Performance. On mobile platforms, which only guarantee 4 render targets, 1 also implies r.ArmASR.OutputAliasesHistory. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<float> CVarArmASRHistoryScale(
+	TEXT("r.ArmASR.HistoryScale"),
+	1.0f,
+	TEXT("Range from 0.5 to 1.0. Resolution of the accumulated history relative to the output resolution. Below 1.0 the history is bilinearly upsampled to the output, fused with RCAS when sharpening is enabled. The history is never smaller than the input resolution. Default is 1.0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRRenderResAuxHistory(
+	TEXT("r.ArmASR.RenderResolutionAuxHistory"),
+	0,
+	TEXT("Store the lock status and temporal reactive histories at render resolution instead of output resolution. They are bilinearly upsampled when reprojected. Not supported on OpenGL ES. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRLumaHistoryMoments(
+	TEXT("r.ArmASR.LumaHistoryMoments"),
+	0,
+	TEXT("Quality preset only. Track luma instability with a running luma mean and standard deviation in an R8G8 texture, instead of the last 4 frames of luma in an R8G8B8A8 texture. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASROutputAliasesHistory(
+	TEXT("r.ArmASR.OutputAliasesHistory"),
+	0,
+	TEXT("When no RCAS pass is needed, hand the colour history to post-processing as the upscaled output instead of writing a separate output texture. Ignored for the Quality R16G16B16A16_Float history when r.PostProcessing.PropagateAlpha is enabled, as its alpha holds the temporal reactive factor. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRLanczosReprojection(
+	TEXT("r.ArmASR.LanczosReprojection"),
+	0,
+	TEXT("Quality preset only. Reproject the colour history with Lanczos2 weights using 9 bilinear fetches, instead of Catmull-Rom (or the 16-tap reference Lanczos2 kernel where FP16 is not supported). Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRRatioSpecializedShaders(
+	TEXT("r.ArmASR.RatioSpecializedShaders"),
+	0,
+	TEXT("Use an Accumulate permutation with the upscale ratio fixed at compile time when the render and history resolutions match 1.5x, 1.7x, 2x or 3x. Other ratios use the generic permutation. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRUpsampleWeightTable(
+	TEXT("r.ArmASR.UpsampleWeightTable"),
+	0,
+	TEXT("Requires r.ArmASR.RatioSpecializedShaders and a matching upscale ratio. Read the upsample Lanczos weights from a table built on the CPU for every phase of the jitter sequence, instead of evaluating them per tap. The table is kept until the ratio or the jitter sequence length changes. Pixels that narrow the kernel (reactive, depth clipped or new samples) still evaluate them. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRLanczosLut(
+	TEXT("r.ArmASR.LanczosLut"),
+	0,
+	TEXT("Read the upsample (and r.ArmASR.LanczosReprojection) Lanczos2 weights from a lookup texture instead of evaluating them. Faster on GPUs that are ALU bound in the Accumulate pass, slower on ones that are texture fetch bound, so it is best set per device profile. Ignored when r.ArmASR.UpsampleWeightTable is in use. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRPartialLumaPyramid(
+	TEXT("r.ArmASR.PartialLumaPyramid"),
+	0,
+	TEXT("Only used when the exposure comes from the engine (r.ArmASR.AutoExposure 0). Only downsample the luminance pyramid down to the shading change mip that Accumulate reads, and only allocate that mip. This skips SPD's last workgroup reduction and its global atomic. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRFusedLumaMip(
+	TEXT("r.ArmASR.FusedLumaMip"),
+	0,
+	TEXT("Only used when the exposure comes from the engine (r.ArmASR.AutoExposure 0), implies r.ArmASR.PartialLumaPyramid and isn't supported on OpenGL. The Depth Clip pass also writes the first, half resolution, level of the luminance pyramid, so the pyramid pass doesn't read the input colour again. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRSpdSubgroupReduction(
+	TEXT("r.ArmASR.SpdSubgroupReduction"),
+	1,
+	TEXT("Where the device's subgroups have 8 lanes or more, reduce the luminance pyramid with subgroup shuffles on top of the quad operations. The shuffles assume that the driver fills subgroups in thread order, set it to 0 to keep the quad operations only on drivers that don't. Default is 1."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRGatherNearestDepth(
+	TEXT("r.ArmASR.GatherNearestDepth"),
+	0,
+	TEXT("Reconstruct Previous Depth fetches the 3x3 depth neighborhood it picks the nearest sample from with four point gathers instead of nine loads. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASREpochTaggedPrevDepth(
+	TEXT("r.ArmASR.EpochTaggedPrevDepth"),
+	0,
+	TEXT("Tag the reconstructed previous depth with a frame epoch and keep it across frames, so texels left over from earlier frames read as empty and it only needs clearing once every 255 frames instead of every frame. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRHalfResPrevDepth(
+	TEXT("r.ArmASR.HalfResPrevDepth"),
+	0,
+	TEXT("Only used by the Performance and Ultra Performance presets. Reconstruct the previous depth at half render resolution, keeping the nearest depth of each 2x2 pixels, which cuts its atomics traffic and memory by 4x at the cost of coarser disocclusion detection. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRGroupsharedNeighborhood(
+	TEXT("r.ArmASR.GroupsharedNeighborhood"),
+	0,
+	TEXT("Not supported on OpenGL. Run Depth Clip as a compute shader, and have it and Lock stage each thread group's tile of their 3x3 neighborhoods in groupshared memory instead of fetching them per pixel. Depth Clip stays a pixel shader when r.ArmASR.FusedLumaMip is in use. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRGroupSwizzle(
+	TEXT("r.ArmASR.GroupSwizzle"),
+	0,
+	TEXT("Width, in thread groups, of the vertical strips that the Depth Clip and Lock compute passes walk their thread groups in, so that the groups in flight together read neighboring tiles. 0 keeps row-major order. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRComputeGroupSize(
+	TEXT("r.ArmASR.ComputeGroupSize"),
+	0,
+	TEXT("Thread group size of the groupshared Depth Clip and Lock compute passes, see r.ArmASR.GroupsharedNeighborhood. 0: 8x8, 1: 8x4, 2: 16x8, 3: 16x16. -1: the size chosen for this GPU and driver, which is timed over the first frames the first time they are seen and stored in the user config. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRComputePassTimings(
+	TEXT("r.ArmASR.ComputePassTimings"),
+	0,
+	TEXT("For benchmarks. When greater than 0, time the groupshared Depth Clip and Lock compute passes with GPU timestamps and log the median time of each over that many frames. The frames restart when r.ArmASR.GroupSwizzle or the thread group size changes. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRRecomputePreparedInputs(
+	TEXT("r.ArmASR.RecomputePreparedInputs"),
+	0,
+	TEXT("Bitmask of the presets (1: Quality, 2: Balanced, 4: Performance) that recompute the prepared input colour and the lock luma from the input colour where they are read, instead of storing them in render resolution targets. Saves bandwidth at the cost of ALU. Ultra Performance always reads the input colour directly. Default is 0."),
+	ECVF_RenderThreadSafe);
+
+TAutoConsoleVariable<int32> CVarArmASRReportUncompressedSurfaces(
+	TEXT("r.ArmASR.ReportUncompressedSurfaces"),
+	0,
+	TEXT("Debug. Log the Arm ASR surfaces that are created with UAV usage, which prevents framebuffer compression (e.g. AFBC) on most tile-based GPUs. Each view logs its report again whenever its list changes. Default is 0."),
+	ECVF_RenderThreadSafe);
+
 TAutoConsoleVariable<int32> CVarArmASRCreateReactiveMask(
 	TEXT("r.ArmASR.CreateReactiveMask"),
 	1,
@@ -155,6 +289,7 @@ IMPLEMENT_GLOBAL_SHADER(FArmASRConvertVelocity, "/Plugin/ArmASR/Private/ConvertV
 IMPLEMENT_GLOBAL_SHADER(FArmASRCopyExposureCS, "/Plugin/ArmASR/Private/CopyExposure.usf", "MainCS", SF_Compute);
 IMPLEMENT_GLOBAL_SHADER(FArmASRCreateReactiveMaskPS, "/Plugin/ArmASR/Private/CreateReactiveMask.usf", "main", SF_Pixel);
 IMPLEMENT_GLOBAL_SHADER(FArmASRDepthClipPS, "/Plugin/ArmASR/Private/DepthClipPass.usf", "main", SF_Pixel);
+IMPLEMENT_GLOBAL_SHADER(FArmASRDepthClipCS, "/Plugin/ArmASR/Private/DepthClipPassCS.usf", "main", SF_Compute);
 IMPLEMENT_GLOBAL_SHADER(FArmASRLockCS, "/Plugin/ArmASR/Private/LockPass.usf", "main", SF_Compute);
 IMPLEMENT_GLOBAL_SHADER(FArmASRRCASPS, "/Plugin/ArmASR/Private/RCASPass.usf", "main", SF_Pixel);
 IMPLEMENT_GLOBAL_SHADER(FArmASRReconstructPrevDepthPS, "/Plugin/ArmASR/Private/ReconstructPrevDepthPass.usf", "main",
@@ -171,7 +306,9 @@ public:
 		DilatedMotionVectors{ nullptr },
 		DilatedDepthMotionVectorsInputLuma{ nullptr },
 		LockStatus{ nullptr },
-		PreExposure { 0.0 }
+		ReconstructedPrevNearestDepth{ nullptr },
+		PreExposure { 0.0 },
+		ReconstructedDepthEpoch{ 0 }
 	{};
 
 	virtual ~FArmASRTemporalAAHistory() = default;
@@ -201,20 +338,24 @@ public:
 		return FRefCountBase::GetRefCount();
 	}
 
-	bool IsValid(const EShaderQualityPreset QualityPreset) const
+	bool IsValid(const EShaderQualityPreset QualityPreset, const bool bCompactHistory, const bool bLumaMoments) const
 	{
 		bool AreRelevantMembersSet = true;
 
 		const bool bIsBalancedOrPerformance = (QualityPreset == EShaderQualityPreset::BALANCED) || (QualityPreset == EShaderQualityPreset::PERFORMANCE);
 		const bool bIsUltraPerformance = (QualityPreset == EShaderQualityPreset::ULTRA_PERFORMANCE);
-		const EPixelFormat InternalUpscaledFormat = (bIsUltraPerformance || bIsBalancedOrPerformance) ? PF_FloatR11G11B10 : PF_FloatRGBA;
+		const EPixelFormat InternalUpscaledFormat = (bIsUltraPerformance || bIsBalancedOrPerformance || bCompactHistory) ? PF_FloatR11G11B10 : PF_FloatRGBA;
 		if (!UpscaledColour || UpscaledColour->GetDesc().Format != InternalUpscaledFormat)
 		{
 			AreRelevantMembersSet = false;
 		}
-		if (!LumaHistory && (QualityPreset == EShaderQualityPreset::QUALITY))
+		if (QualityPreset == EShaderQualityPreset::QUALITY)
 		{
-			AreRelevantMembersSet = false;
+			const EPixelFormat LumaHistoryFormat = bLumaMoments ? PF_R8G8 : PF_R8G8B8A8;
+			if (!LumaHistory || LumaHistory->GetDesc().Format != LumaHistoryFormat)
+			{
+				AreRelevantMembersSet = false;
+			}
 		}
 		if (!DilatedMotionVectors && (QualityPreset != EShaderQualityPreset::ULTRA_PERFORMANCE))
 		{
@@ -228,7 +369,7 @@ public:
 		{
 			AreRelevantMembersSet = false;
 		}
-		if (!InternalReactive && (QualityPreset != EShaderQualityPreset::QUALITY))
+		if (!InternalReactive && (bIsBalancedOrPerformance || bCompactHistory))
 		{
 			AreRelevantMembersSet = false;
 		}
@@ -260,8 +401,17 @@ public:
 		{
 			Size += LockStatus->ComputeMemorySize();
 		}
+		if (ReconstructedPrevNearestDepth)
+		{
+			Size += ReconstructedPrevNearestDepth->ComputeMemorySize();
+		}
+		if (UpsampleWeightTable.Buffer)
+		{
+			Size += UpsampleWeightTable.Buffer->GetSize();
+		}
 
 		Size += sizeof(PreExposure);
+		Size += sizeof(ReconstructedDepthEpoch);
 
 		return Size;
 	}
@@ -272,12 +422,291 @@ public:
 	TRefCountPtr<IPooledRenderTarget> DilatedMotionVectors;
 	TRefCountPtr<IPooledRenderTarget> DilatedDepthMotionVectorsInputLuma;
 	TRefCountPtr<IPooledRenderTarget> LockStatus;
-	TRefCountPtr<IPooledRenderTarget> NewLock;
+	// Not part of IsValid: the epoch tag already rejects stale texels, so it survives camera cuts and preset changes.
+	TRefCountPtr<IPooledRenderTarget> ReconstructedPrevNearestDepth;
 	float PreExposure;
+	uint32 ReconstructedDepthEpoch;
+	// Last r.ArmASR.ReportUncompressedSurfaces report of this view, so that each view only logs when its own list changes.
+	FString UncompressedSurfacesReport;
+	// Not part of IsValid: it only depends on the upscale ratio and jitter sequence it is keyed on.
+	FArmASRUpsampleWeightTable UpsampleWeightTable;
 };
 
 static int32_t FRAME_INDEX = 0;
 
+// Logs the textures that were created with UAV usage when the list differs from the view's LastReport, and returns it.
+// Only RHI knows whether a surface ends up compressed, but on tile-based GPUs storage image usage generally disables
+// framebuffer compression for the whole surface.
+static FString ReportUncompressedSurfaces(TConstArrayView<FRDGTextureRef> Textures, const FString& LastReport)
+{
+	FString Report;
+	for (FRDGTextureRef Texture : Textures)
+	{
+		if (Texture && EnumHasAnyFlags(Texture->Desc.Flags, TexCreate_UAV))
+		{
+			Report += FString::Printf(TEXT("\n\t%s (%dx%d, %s)"),
+				Texture->Name,
+				Texture->Desc.Extent.X,
+				Texture->Desc.Extent.Y,
+				GPixelFormats[Texture->Desc.Format].Name);
+		}
+	}
+
+	if (Report != LastReport)
+	{
+		UE_LOG(LogArmASR, Log, TEXT("Arm ASR surfaces with UAV usage (likely uncompressed):%s"), Report.IsEmpty() ? TEXT(" none") : *Report);
+	}
+	return Report;
+}
+
+static constexpr int32 ComputeGroupSizeCount = 4;
+static constexpr int32 ComputeGroupSizeSamples = 32;
+static const TCHAR* ComputeGroupSizeConfigSection = TEXT("ArmASR");
+
+static bool IsComputeGroupSizeSupported(int32 Index)
+{
+	const FIntPoint GroupSize = GetArmASRComputeGroupSize(Index);
+	return (Index >= 0) && (Index < ComputeGroupSizeCount) && (GroupSize.X * GroupSize.Y <= GMaxWorkGroupInvocations);
+}
+
+// Identifies the GPU and its driver in the user config, so that a new GPU or driver is timed again.
+static FString GetComputeGroupSizeDeviceKey()
+{
+	FString Key = FString::Printf(TEXT("ComputeGroupSize_%04X_%04X_%s_%s"), GRHIVendorId, GRHIDeviceId, *GRHIAdapterName, *GRHIAdapterUserDriverVersion);
+	for (TCHAR& Character : Key)
+	{
+		if (!FChar::IsAlnum(Character))
+		{
+			Character = TEXT('_');
+		}
+	}
+	return Key;
+}
+
+// Collects the finished timings and, once every candidate has enough of them, keeps the one with the lowest median and
+// stores it in the user config.
+static void ResolveComputeGroupSizeTimings(FArmASRComputeGroupSizeTuning& Tuning)
+{
+	while (Tuning.Pending.Num() > 0)
+	{
+		FArmASRComputeGroupSizeTuning::FPendingTiming& Timing = Tuning.Pending[0];
+		uint64 BeginMicroseconds = 0;
+		uint64 EndMicroseconds = 0;
+		if (!RHIGetRenderQueryResult(Timing.End.GetQuery(), EndMicroseconds, false) ||
+			!RHIGetRenderQueryResult(Timing.Begin.GetQuery(), BeginMicroseconds, false))
+		{
+			break;
+		}
+
+		if (Tuning.Selected == INDEX_NONE && EndMicroseconds > BeginMicroseconds)
+		{
+			Tuning.Samples[Timing.Candidate].Add(EndMicroseconds - BeginMicroseconds);
+		}
+		Tuning.Pending.RemoveAt(0);
+	}
+
+	if (Tuning.Selected != INDEX_NONE)
+	{
+		return;
+	}
+
+	int32 Winner = INDEX_NONE;
+	uint64 WinnerMicroseconds = MAX_uint64;
+	for (int32 Candidate = 0; Candidate < ComputeGroupSizeCount; ++Candidate)
+	{
+		if (!IsComputeGroupSizeSupported(Candidate))
+		{
+			continue;
+		}
+
+		TArray<uint64>& Samples = Tuning.Samples[Candidate];
+		if (Samples.Num() < ComputeGroupSizeSamples)
+		{
+			return;
+		}
+
+		Samples.Sort();
+		const uint64 MedianMicroseconds = Samples[Samples.Num() / 2];
+		if (MedianMicroseconds < WinnerMicroseconds)
+		{
+			Winner = Candidate;
+			WinnerMicroseconds = MedianMicroseconds;
+		}
+	}
+
+	Tuning.Selected = Winner;
+	Tuning.Samples.Empty();
+
+	const FIntPoint GroupSize = GetArmASRComputeGroupSize(Winner);
+	UE_LOG(LogArmASR, Log, TEXT("Arm ASR compute thread group size for this device: %dx%d (%llu us median)."), GroupSize.X, GroupSize.Y, WinnerMicroseconds);
+
+	// The queries are not needed anymore. The config is written on the game thread and saved with the other user settings.
+	Tuning.QueryPool.SafeRelease();
+	AsyncTask(ENamedThreads::GameThread, [DeviceKey = Tuning.DeviceKey, Winner]()
+	{
+		GConfig->SetInt(ComputeGroupSizeConfigSection, *DeviceKey, Winner, GGameUserSettingsIni);
+	});
+}
+
+// Returns the FArmASR_ComputeGroupSize index for this frame. bGroupsharedNeighborhood is whether any pass uses the
+// size. When tuning, until a size has been chosen for the device, the frames cycle through the candidates and
+// OutBeginQuery and OutEndQuery are set to time the passes that use it with.
+static int32 SelectComputeGroupSize(FArmASRComputeGroupSizeTuning& Tuning, bool bGroupsharedNeighborhood, FRHIRenderQuery*& OutBeginQuery, FRHIRenderQuery*& OutEndQuery)
+{
+	OutBeginQuery = nullptr;
+	OutEndQuery = nullptr;
+
+	// The other sizes only have shader permutations when the project compiled the experimental ones.
+	if (!bGroupsharedNeighborhood || !AreArmASRExperimentalPermutationsEnabled())
+	{
+		return 0;
+	}
+
+	const int32 RequestedGroupSize = CVarArmASRComputeGroupSize.GetValueOnRenderThread();
+	if (RequestedGroupSize >= 0)
+	{
+		return IsComputeGroupSizeSupported(RequestedGroupSize) ? RequestedGroupSize : 0;
+	}
+
+	if (Tuning.Selected == INDEX_NONE && !GRHISupportsTimestampRenderQueries)
+	{
+		Tuning.Selected = 0;
+	}
+
+	if (Tuning.Samples.Num() == 0 && Tuning.Selected == INDEX_NONE)
+	{
+		Tuning.Samples.SetNum(ComputeGroupSizeCount);
+	}
+
+	ResolveComputeGroupSizeTimings(Tuning);
+	if (Tuning.Selected != INDEX_NONE)
+	{
+		return Tuning.Selected;
+	}
+
+	TArray<int32, TInlineAllocator<ComputeGroupSizeCount>> Candidates;
+	for (int32 Candidate = 0; Candidate < ComputeGroupSizeCount; ++Candidate)
+	{
+		if (IsComputeGroupSizeSupported(Candidate))
+		{
+			Candidates.Add(Candidate);
+		}
+	}
+
+	// Alternating every frame keeps the candidates on comparable content.
+	const int32 Candidate = Candidates[Tuning.FrameIndex++ % Candidates.Num()];
+
+	if (!Tuning.QueryPool)
+	{
+		Tuning.QueryPool = RHICreateRenderQueryPool(RQT_AbsoluteTime);
+	}
+	FArmASRComputeGroupSizeTuning::FPendingTiming& Timing = Tuning.Pending.AddDefaulted_GetRef();
+	Timing.Begin = Tuning.QueryPool->AllocateQuery();
+	Timing.End = Tuning.QueryPool->AllocateQuery();
+	Timing.Candidate = Candidate;
+	OutBeginQuery = Timing.Begin.GetQuery();
+	OutEndQuery = Timing.End.GetQuery();
+
+	return Candidate;
+}
+
+static void AddTimestampPass(FRDGBuilder& GraphBuilder, FRHIRenderQuery* Query)
+{
+	GraphBuilder.AddPass(RDG_EVENT_NAME("ArmASRTimestamp"), ERDGPassFlags::NeverCull, [Query](FRHICommandListImmediate& RHICmdList)
+	{
+		RHICmdList.EndRenderQuery(Query);
+	});
+}
+
+// Collects the finished timings of r.ArmASR.ComputePassTimings and logs the median of each pass once there are
+// SampleCount of them.
+static void ResolveComputePassTimings(FArmASRComputePassTimings& Timings, int32 SampleCount)
+{
+	while (Timings.Pending.Num() > 0)
+	{
+		FArmASRComputePassTimings::FPendingTiming& Timing = Timings.Pending[0];
+		uint64 BeginMicroseconds = 0;
+		uint64 DepthClipEndMicroseconds = 0;
+		uint64 LockEndMicroseconds = 0;
+		if (!RHIGetRenderQueryResult(Timing.LockEnd.GetQuery(), LockEndMicroseconds, false) ||
+			!RHIGetRenderQueryResult(Timing.DepthClipEnd.GetQuery(), DepthClipEndMicroseconds, false) ||
+			!RHIGetRenderQueryResult(Timing.Begin.GetQuery(), BeginMicroseconds, false))
+		{
+			break;
+		}
+
+		// Frames still in flight when the settings changed are dropped.
+		if (Timing.GroupSwizzle == Timings.GroupSwizzle && Timing.ComputeGroupSize == Timings.ComputeGroupSize &&
+			DepthClipEndMicroseconds >= BeginMicroseconds && LockEndMicroseconds >= DepthClipEndMicroseconds)
+		{
+			Timings.DepthClipSamples.Add(DepthClipEndMicroseconds - BeginMicroseconds);
+			Timings.LockSamples.Add(LockEndMicroseconds - DepthClipEndMicroseconds);
+		}
+		Timings.Pending.RemoveAt(0);
+	}
+
+	if (Timings.DepthClipSamples.Num() < SampleCount)
+	{
+		return;
+	}
+
+	Timings.DepthClipSamples.Sort();
+	Timings.LockSamples.Sort();
+	const FIntPoint GroupSize = GetArmASRComputeGroupSize(Timings.ComputeGroupSize);
+	UE_LOG(LogArmASR, Display, TEXT("Arm ASR compute pass GPU times with r.ArmASR.GroupSwizzle %d and %dx%d thread groups, median of %d frames: Depth Clip %llu us, Lock %llu us."),
+		Timings.GroupSwizzle, GroupSize.X, GroupSize.Y, Timings.DepthClipSamples.Num(), Timings.DepthClipSamples[Timings.DepthClipSamples.Num() / 2], Timings.LockSamples[Timings.LockSamples.Num() / 2]);
+	Timings.DepthClipSamples.Reset();
+	Timings.LockSamples.Reset();
+}
+
+// Sets OutBeginQuery, OutDepthClipEndQuery and OutLockEndQuery to time this frame's compute Depth Clip and Lock passes
+// with, when r.ArmASR.ComputePassTimings is set. bComputeDepthClip is whether Depth Clip runs as a compute shader,
+// directly followed by Lock.
+static void SelectComputePassTimingQueries(FArmASRComputePassTimings& Timings, bool bComputeDepthClip, int32 GroupSwizzle, int32 ComputeGroupSize,
+	FRHIRenderQuery*& OutBeginQuery, FRHIRenderQuery*& OutDepthClipEndQuery, FRHIRenderQuery*& OutLockEndQuery)
+{
+	OutBeginQuery = nullptr;
+	OutDepthClipEndQuery = nullptr;
+	OutLockEndQuery = nullptr;
+
+	const int32 SampleCount = CVarArmASRComputePassTimings.GetValueOnRenderThread();
+	if (SampleCount <= 0 || !bComputeDepthClip || !GRHISupportsTimestampRenderQueries)
+	{
+		// The queries of the frames in flight are collected, and their timings dropped, before the pool is released.
+		Timings.GroupSwizzle = INDEX_NONE;
+		Timings.ComputeGroupSize = INDEX_NONE;
+		ResolveComputePassTimings(Timings, MAX_int32);
+		if (Timings.Pending.Num() == 0)
+		{
+			Timings.QueryPool.SafeRelease();
+		}
+		return;
+	}
+
+	if (GroupSwizzle != Timings.GroupSwizzle || ComputeGroupSize != Timings.ComputeGroupSize)
+	{
+		Timings.GroupSwizzle = GroupSwizzle;
+		Timings.ComputeGroupSize = ComputeGroupSize;
+		Timings.DepthClipSamples.Reset();
+		Timings.LockSamples.Reset();
+	}
+	ResolveComputePassTimings(Timings, SampleCount);
+
+	if (!Timings.QueryPool)
+	{
+		Timings.QueryPool = RHICreateRenderQueryPool(RQT_AbsoluteTime);
+	}
+	FArmASRComputePassTimings::FPendingTiming& Timing = Timings.Pending.AddDefaulted_GetRef();
+	Timing.Begin = Timings.QueryPool->AllocateQuery();
+	Timing.DepthClipEnd = Timings.QueryPool->AllocateQuery();
+	Timing.LockEnd = Timings.QueryPool->AllocateQuery();
+	Timing.GroupSwizzle = GroupSwizzle;
+	Timing.ComputeGroupSize = ComputeGroupSize;
+	OutBeginQuery = Timing.Begin.GetQuery();
+	OutDepthClipEndQuery = Timing.DepthClipEnd.GetQuery();
+	OutLockEndQuery = Timing.LockEnd.GetQuery();
+}
+
 FArmASRTemporalUpscaler::FArmASRTemporalUpscaler(FArmASRInfo& ArmASRInfo, FArmASRPassthroughDenoiser& Denoiser)
 	: ArmASRInfo(ArmASRInfo), Denoiser(Denoiser)
 {
@@ -290,6 +719,16 @@ FArmASRTemporalUpscaler::FArmASRTemporalUpscaler(FArmASRInfo& ArmASRInfo, FArmAS
 			{
 				return new ArmASRFXSystem(ArmASRInfo, InGPUSortManager);
 			}));
+
+	// Reuse the thread group size chosen the last time this GPU and driver were used.
+	FArmASRComputeGroupSizeTuning& ComputeGroupSizeTuning = ArmASRInfo.ComputeGroupSizeTuning;
+	ComputeGroupSizeTuning.DeviceKey = GetComputeGroupSizeDeviceKey();
+	int32 CachedComputeGroupSize = INDEX_NONE;
+	if (GConfig->GetInt(ComputeGroupSizeConfigSection, *ComputeGroupSizeTuning.DeviceKey, CachedComputeGroupSize, GGameUserSettingsIni) &&
+		IsComputeGroupSizeSupported(CachedComputeGroupSize))
+	{
+		ComputeGroupSizeTuning.Selected = CachedComputeGroupSize;
+	}
 }
 
 FArmASRTemporalUpscaler::~FArmASRTemporalUpscaler()
@@ -319,6 +758,34 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	const bool bIsBalancedOrPerformance = (QualityPreset == EShaderQualityPreset::BALANCED) || (QualityPreset == EShaderQualityPreset::PERFORMANCE);
 	const bool bIsPerformance = (QualityPreset == EShaderQualityPreset::PERFORMANCE);
 	const bool bIsUltraPerformance = (QualityPreset == EShaderQualityPreset::ULTRA_PERFORMANCE);
+	// The experimental options have no shader permutations unless the project compiled them.
+	const bool bExperimentalPermutations = AreArmASRExperimentalPermutationsEnabled();
+	// Quality can store its colour history like Balanced/Performance, with the temporal reactive factor in a separate texture.
+	const bool bUseCompactHistory = bExperimentalPermutations && bIsQuality && (CVarArmASRHistoryEncoding.GetValueOnRenderThread() == 1);
+	const bool bSeparateTemporalReactive = bIsBalancedOrPerformance || bUseCompactHistory;
+	const bool bUseLumaMoments = bExperimentalPermutations && bIsQuality && (CVarArmASRLumaHistoryMoments.GetValueOnRenderThread() == 1);
+	const bool bUseLanczosReprojection = bExperimentalPermutations && bIsQuality && (CVarArmASRLanczosReprojection.GetValueOnRenderThread() == 1);
+	// The lock status and temporal reactive histories are written through pixel shader UAVs in this mode.
+	const bool bRenderResAuxHistory = bExperimentalPermutations && CVarArmASRRenderResAuxHistory.GetValueOnRenderThread() && !IsOpenGLPlatform(GMaxRHIShaderPlatform);
+	const bool bRecomputePreparedInputs = bExperimentalPermutations && !bIsUltraPerformance && ((CVarArmASRRecomputePreparedInputs.GetValueOnRenderThread() >> (int32(QualityPreset) - 1)) & 1);
+	// The full pyramid is only needed to reduce it to the auto exposure, which Depth Clip also needs before the fused first level is written.
+	const bool bFusedLumaMip = bExperimentalPermutations && !bIsUltraPerformance && !bRequestedAutoExposure && !IsOpenGLPlatform(GMaxRHIShaderPlatform) && (CVarArmASRFusedLumaMip.GetValueOnRenderThread() == 1);
+	const bool bGatherNearestDepth = bExperimentalPermutations && (CVarArmASRGatherNearestDepth.GetValueOnRenderThread() == 1);
+	const bool bEpochTaggedPrevDepth = bExperimentalPermutations && (CVarArmASREpochTaggedPrevDepth.GetValueOnRenderThread() == 1);
+	const bool bHalfResPrevDepth = bExperimentalPermutations && (bIsPerformance || bIsUltraPerformance) && (CVarArmASRHalfResPrevDepth.GetValueOnRenderThread() == 1);
+	const bool bGroupsharedNeighborhood = bExperimentalPermutations && (CVarArmASRGroupsharedNeighborhood.GetValueOnRenderThread() == 1) && !IsOpenGLPlatform(GMaxRHIShaderPlatform);
+	// The fused luma mip relies on pixel quad derivatives.
+	const bool bComputeDepthClip = bGroupsharedNeighborhood && !bFusedLumaMip;
+	const bool bPartialLumaPyramid = bExperimentalPermutations && !bIsUltraPerformance && !bRequestedAutoExposure && ((CVarArmASRPartialLumaPyramid.GetValueOnRenderThread() == 1) || bFusedLumaMip);
+	FRHIRenderQuery* ComputeGroupSizeBeginQuery = nullptr;
+	FRHIRenderQuery* ComputeGroupSizeEndQuery = nullptr;
+	const int32 ComputeGroupSizeIndex = SelectComputeGroupSize(ArmASRInfo.ComputeGroupSizeTuning, bGroupsharedNeighborhood, ComputeGroupSizeBeginQuery, ComputeGroupSizeEndQuery);
+	const FIntPoint ComputeGroupSize = GetArmASRComputeGroupSize(ComputeGroupSizeIndex);
+	const int32 GroupSwizzleWidth = FMath::Max(CVarArmASRGroupSwizzle.GetValueOnRenderThread(), 0);
+	FRHIRenderQuery* ComputePassBeginQuery = nullptr;
+	FRHIRenderQuery* DepthClipEndQuery = nullptr;
+	FRHIRenderQuery* LockEndQuery = nullptr;
+	SelectComputePassTimingQueries(ArmASRInfo.ComputePassTimings, bComputeDepthClip, GroupSwizzleWidth, ComputeGroupSizeIndex, ComputePassBeginQuery, DepthClipEndQuery, LockEndQuery);
 
 	const float Sharpness = FMath::Clamp(CVarArmASRSharpness.GetValueOnRenderThread(), 0.0f, 1.0f);
 	const bool bApplySharpening = (Sharpness > 0.0f);
@@ -332,8 +799,25 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	FIntPoint OutputExtents = ViewInfo.GetSecondaryViewRectSize();
 	OutputExtents = FIntPoint(FMath::Max(InputExtents.X, OutputExtents.X), FMath::Max(InputExtents.Y, OutputExtents.Y));
 
+	// The history, and every pass working at output resolution, can run at a fraction of the output resolution.
+	// In that case the history is upsampled to the output by the RCAS pass.
+	const float HistoryScale = FMath::Clamp(CVarArmASRHistoryScale.GetValueOnRenderThread(), 0.5f, 1.0f);
+	FIntPoint HistoryExtents(FMath::CeilToInt(OutputExtents.X * HistoryScale), FMath::CeilToInt(OutputExtents.Y * HistoryScale));
+	HistoryExtents = FIntPoint(FMath::Max(InputExtents.X, HistoryExtents.X), FMath::Max(InputExtents.Y, HistoryExtents.Y));
+	const bool bUpsampleHistory = (HistoryExtents != OutputExtents);
+	const bool bUseRCAS = bApplySharpening || bUpsampleHistory;
+
+	// Without RCAS the output is identical to the colour history, so the history itself can be the output.
+	static const IConsoleVariable* CVarPropagateAlpha = IConsoleManager::Get().FindConsoleVariable(TEXT("r.PostProcessing.PropagateAlpha"));
+	const bool bHistoryHasAlpha = bIsQuality && !bUseCompactHistory;
+	const bool bPropagateAlpha = CVarPropagateAlpha && (CVarPropagateAlpha->GetInt() != 0);
+	// The compact Quality history has no alpha, and would need a fifth target for the output where only 4 are guaranteed.
+	const bool bCompactHistoryNeedsAlias = bUseCompactHistory && !bRenderResAuxHistory && IsAccumulateLimitedToFourTargets(GMaxRHIShaderPlatform);
+	const bool bOutputAliasesHistory = (CVarArmASROutputAliasesHistory.GetValueOnRenderThread() || bCompactHistoryNeedsAlias) && !bUseRCAS && !(bHistoryHasAlpha && bPropagateAlpha);
+
 	FScreenPassTextureViewport InputViewport(FIntRect(0, 0, InputExtents.X, InputExtents.Y));
 	FScreenPassTextureViewport OutputViewport(FIntRect(0, 0, OutputExtents.X, OutputExtents.Y));
+	FScreenPassTextureViewport HistoryViewport(FIntRect(0, 0, HistoryExtents.X, HistoryExtents.Y));
 
 	FIntPoint InputExtentsQuantized;
 	FIntPoint OutputExtentsQuantized;
@@ -355,13 +839,18 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	FRDGTextureSRVDesc MotionVectorDesc = FRDGTextureSRVDesc::Create(VelocityTexture);
 
 	// Create the output texture and assign it to Outputs. This will be updated in the Accumulate or RCAS shader.
-	FRDGTextureDesc OutputColorDesc = Inputs.SceneColor.Texture->Desc;
-	OutputColorDesc.Extent = OutputExtents;
-	OutputColorDesc.Flags = TexCreate_ShaderResource | TexCreate_RenderTargetable;
-	Outputs.FullRes.Texture = GraphBuilder.CreateTexture(
-		OutputColorDesc,
-		TEXT("ArmASROutputSceneColor"),
-		ERDGTextureFlags::MultiFrame);
+	// The output is consumed by the rest of post-processing within this graph, so it does not need to be MultiFrame
+	// and can be aliased by RDG once post-processing is done with it.
+	// When the output aliases the history, it is assigned once the Accumulate pass has created the history.
+	if (!bOutputAliasesHistory)
+	{
+		FRDGTextureDesc OutputColorDesc = Inputs.SceneColor.Texture->Desc;
+		OutputColorDesc.Extent = OutputExtents;
+		OutputColorDesc.Flags = TexCreate_ShaderResource | TexCreate_RenderTargetable;
+		Outputs.FullRes.Texture = GraphBuilder.CreateTexture(
+			OutputColorDesc,
+			TEXT("ArmASROutputSceneColor"));
+	}
 	Outputs.FullRes.ViewRect = Inputs.OutputViewRect;
 
 	// Get previous history. These textures will be used as inputs for some of the shaders.
@@ -371,48 +860,40 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	FRDGTextureRef PrevDilatedMotionVectors{ nullptr };
 	FRDGTextureRef PrevDilatedDepthMotionVectorsInputLuma{nullptr};
 	FRDGTextureRef PrevLockStatus{ nullptr };
-	FRDGTextureRef NewLock{ nullptr };
 	float PrevPreExposure{ 0.0 };
 
 	FArmASRTemporalAAHistory* PrevHistory = static_cast<FArmASRTemporalAAHistory*>(Inputs.PrevHistory.GetReference());
+	// Kept across camera cuts and preset changes, GetUpsampleWeightTable rebuilds it when its key changes.
+	FArmASRUpsampleWeightTable UpsampleWeightTable = PrevHistory ? PrevHistory->UpsampleWeightTable : FArmASRUpsampleWeightTable();
 
 	// Check for camera cuts and a valid history.
 	bool bCameraCut = View.bCameraCut || !ViewInfo.ViewState;
-	bool ValidHistory = PrevHistory && PrevHistory->IsValid(QualityPreset) && !bCameraCut;
+	bool ValidHistory = PrevHistory && PrevHistory->IsValid(QualityPreset, bUseCompactHistory, bUseLumaMoments) && !bCameraCut;
 
 	if (ValidHistory)
 	{
 		PrevUpscaledColour = GraphBuilder.RegisterExternalTexture(PrevHistory->UpscaledColour, TEXT("PrevUpscaledColour"));
 
-		// Balanced/Performance/UltraPerformance preset specific
-		if (!bIsQuality)
+		// Balanced/Performance preset and compact Quality history specific
+		if (bSeparateTemporalReactive)
 		{
 			// Internal reactive history
 			PrevInternalReactive = GraphBuilder.RegisterExternalTexture(PrevHistory->InternalReactive, TEXT("InternalReactive"));
-
-			// Luma history not used when using Balanced/Performance preset
-			PrevLumaHistory = GSystemTextures.GetBlackDummy(GraphBuilder);
 		}
 		else
 		{
-			PrevLumaHistory = GraphBuilder.RegisterExternalTexture(PrevHistory->LumaHistory, TEXT("PrevLumaHistory"));
-
 			// Separate internal reactive not used by Quality preset. Internal upscaled color (R16G16B16A16_Float) contains this in Alpha channel
 			PrevInternalReactive = GSystemTextures.GetBlackDummy(GraphBuilder);
 		}
 
-		// Lock pass output (UAV-based feedback loop)
-		if (!PrevHistory->NewLock.IsValid())
+		if (bIsQuality)
 		{
-			FRDGTextureDesc LockMaskDesc =
-				FRDGTextureDesc::Create2D(OutputExtents, maskFormat, FClearValueBinding::Black,
-										  TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable, 1, 1);
-			NewLock = GraphBuilder.CreateTexture(LockMaskDesc, TEXT("LockMaskTexture"));
-
+			PrevLumaHistory = GraphBuilder.RegisterExternalTexture(PrevHistory->LumaHistory, TEXT("PrevLumaHistory"));
 		}
 		else
 		{
-			NewLock = GraphBuilder.RegisterExternalTexture(PrevHistory->NewLock, TEXT("LockMaskTexture"));
+			// Luma history not used when using Balanced/Performance preset
+			PrevLumaHistory = GSystemTextures.GetBlackDummy(GraphBuilder);
 		}
 
 		if (bIsUltraPerformance)
@@ -436,39 +917,39 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 		PrevLockStatus = GSystemTextures.GetBlackDummy(GraphBuilder);
 		PrevInternalReactive = GSystemTextures.GetBlackDummy(GraphBuilder);
 
-		// Create New Lock texture.
-		FRDGTextureDesc LockMaskDesc =
-			FRDGTextureDesc::Create2D(OutputExtents, maskFormat, FClearValueBinding::Black,
-									  TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable, 1, 1);
-		NewLock = GraphBuilder.CreateTexture(LockMaskDesc, TEXT("LockMaskTexture"));
-
 		// Reset the frame index.
 		FRAME_INDEX = 0;
 	}
-	AddClearRenderTargetPass(GraphBuilder, NewLock);
 
-	FRDGTextureRef ReactiveMaskTexture = nullptr;
-	FRDGTextureRef CompositeMaskTexture = nullptr;
+	// Lock pass output. It is cleared every frame and only read by the Accumulate pass of the same frame,
+	// so it is kept as a transient texture rather than carried in the history.
+	// It is only ever written through a UAV, so it is cleared as one and not made render targetable.
+	// R8 is already the narrowest format for it; OpenGL ES has no R8 image format, so it uses R32F there.
+	FRDGTextureDesc LockMaskDesc =
+		FRDGTextureDesc::Create2D(HistoryExtents, maskFormat, FClearValueBinding::Black,
+								  TexCreate_ShaderResource | TexCreate_UAV, 1, 1);
+	FRDGTextureRef NewLock = GraphBuilder.CreateTexture(LockMaskDesc, TEXT("LockMaskTexture"));
+	AddClearUAVPass(GraphBuilder, GraphBuilder.CreateUAV(NewLock), 0.0f);
+
+	FRDGTextureRef ReactiveAndCompositeMaskTexture = nullptr;
 
 	if (!bIsUltraPerformance && CVarArmASRCreateReactiveMask.GetValueOnRenderThread() &&
 		ArmASRInfo.PostInputs.SceneTextures)
 	{
-		FRDGTextureDesc ReactiveMaskDesc =
-			FRDGTextureDesc::Create2D(InputExtents, maskFormat, FClearValueBinding::Black,
-									  TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable);
-		FRDGTextureDesc CompositeMaskDesc =
-			FRDGTextureDesc::Create2D(InputExtents, maskFormat, FClearValueBinding::Black,
-									  TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable);
+		// Reactive mask in R and composite mask in G, so Depth Clip only needs a single texture for both.
+		// Written by a pixel shader, so keep it free of UAV usage to allow framebuffer compression.
+		const EPixelFormat ReactiveAndCompositeMaskFormat = IsOpenGLPlatform(GMaxRHIShaderPlatform) ? PF_G16R16F : PF_R8G8;
+		FRDGTextureDesc ReactiveAndCompositeMaskDesc =
+			FRDGTextureDesc::Create2D(InputExtents, ReactiveAndCompositeMaskFormat, FClearValueBinding::Black,
+									  TexCreate_ShaderResource | TexCreate_RenderTargetable);
 
-		ReactiveMaskTexture = GraphBuilder.CreateTexture(ReactiveMaskDesc, TEXT("ArmASRReactiveMaskTexture"));
-		CompositeMaskTexture = GraphBuilder.CreateTexture(CompositeMaskDesc, TEXT("ArmASRCompositeMaskTexture"));
+		ReactiveAndCompositeMaskTexture = GraphBuilder.CreateTexture(ReactiveAndCompositeMaskDesc, TEXT("ArmASRReactiveAndCompositeMaskTexture"));
 
 		FArmASRCreateReactiveMaskPS::FParameters* PassParameters = GraphBuilder.AllocParameters<FArmASRCreateReactiveMaskPS::FParameters>();
 		SetReactiveMaskParameters(GraphBuilder, PassParameters, ArmASRInfo,
 			InputExtents,
 			InputViewport.Rect,
-			ReactiveMaskTexture,
-			CompositeMaskTexture,
+			ReactiveAndCompositeMaskTexture,
 			SceneDepth,
 			SceneColor,
 			VelocityTexture,
@@ -484,17 +965,15 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	}
 	else
 	{
-		ReactiveMaskTexture = GraphBuilder.RegisterExternalTexture(GSystemTextures.BlackDummy);
-		CompositeMaskTexture = GraphBuilder.RegisterExternalTexture(GSystemTextures.BlackDummy);
+		ReactiveAndCompositeMaskTexture = GraphBuilder.RegisterExternalTexture(GSystemTextures.BlackDummy);
 	}
 
 	// Convert Motion Vectors texture to R16G16_Float, so they can be used correctly by the shaders.
-	FRDGTextureDesc MotionVectorDescNew = FRDGTextureDesc::Create2D(InputExtentsQuantized, PF_G16R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable);
+	FRDGTextureDesc MotionVectorDescNew = FRDGTextureDesc::Create2D(InputExtentsQuantized, PF_G16R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable);
 	FRDGTextureRef MotionVectorTextureNew = GraphBuilder.CreateTexture(MotionVectorDescNew, TEXT("ArmASRMotionVectorTexture"));
 	{
 		FArmASRConvertVelocity::FParameters* ConvertVelocityParameters = GraphBuilder.AllocParameters<FArmASRConvertVelocity::FParameters>();
 
-		FRDGTextureUAVDesc OutputDesc(MotionVectorTextureNew);
 		ConvertVelocityParameters->DepthTexture = SceneDepth;
 		ConvertVelocityParameters->InputDepth = GraphBuilder.CreateSRV(DepthDesc);
 		ConvertVelocityParameters->InputVelocity = GraphBuilder.CreateSRV(MotionVectorDesc);
@@ -515,11 +994,31 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	// Setup common parameters
 	FArmASRPassParameters* ArmASRPassParameters = GraphBuilder.AllocParameters<FArmASRPassParameters>();
 	const FIntPoint& ResourceDimensions = SceneColor->Desc.Extent;
-	SetCommonParameters(ArmASRPassParameters, FRAME_INDEX, PrevPreExposure, InputExtents, OutputExtents, ViewInfo, ResourceDimensions);
+	SetCommonParameters(ArmASRPassParameters, FRAME_INDEX, PrevPreExposure, InputExtents, HistoryExtents, ViewInfo, ResourceDimensions);
+
+	ArmASRPassParameters->uGroupSwizzleWidth = GroupSwizzleWidth;
 
 	// Update frame index for next frame.
 	FRAME_INDEX = (FRAME_INDEX + 1);
 
+	// Reuse the previous reconstructed depth until its 8-bit epoch wraps. It then starts again from a cleared texture at epoch 1,
+	// so epoch 0 never matches and stale texels always have a lower epoch than the current one.
+	FRDGTextureRef EpochTaggedNearestDepthTexture = nullptr;
+	if (bEpochTaggedPrevDepth)
+	{
+		if (PrevHistory && PrevHistory->ReconstructedPrevNearestDepth &&
+			PrevHistory->ReconstructedPrevNearestDepth->GetDesc().Extent == (bHalfResPrevDepth ? FIntPoint::DivideAndRoundUp(InputExtents, 2) : InputExtents) &&
+			PrevHistory->ReconstructedDepthEpoch < 255)
+		{
+			EpochTaggedNearestDepthTexture = GraphBuilder.RegisterExternalTexture(PrevHistory->ReconstructedPrevNearestDepth, TEXT("ReconstructedPreviousNearestDepthTexture"));
+			ArmASRPassParameters->uReconstructedDepthEpoch = PrevHistory->ReconstructedDepthEpoch + 1;
+		}
+		else
+		{
+			ArmASRPassParameters->uReconstructedDepthEpoch = 1;
+		}
+	}
+
 	// Assign common parameters to buffer.
 	TUniformBufferRef<FArmASRPassParameters> ArmASRPassParametersBuffer = TUniformBufferRef<FArmASRPassParameters>::CreateUniformBufferImmediate(*ArmASRPassParameters, UniformBuffer_SingleDraw);
 
@@ -527,7 +1026,8 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	// ------------------------
 	FArmASRComputeLuminancePyramidCS::FParameters* ClpShaderParameters = GraphBuilder.AllocParameters<FArmASRComputeLuminancePyramidCS::FParameters>();
 	FArmASRComputeLuminanceParameters* ClpParameters = GraphBuilder.AllocParameters<FArmASRComputeLuminanceParameters>();
-	if (!bIsUltraPerformance)
+	// Runs after Depth Clip instead when its first level is fused into it.
+	auto AddComputeLuminancePyramidPass = [&](const FRDGTextureRef LumaMip0Texture)
 	{
 		FIntVector workgroupCount(0, 0, 0);
 		SetComputeLuminancePyramidParameters(
@@ -536,15 +1036,17 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 			ArmASRPassParametersBuffer,
 			SceneColorTexture,
 			InputExtents,
+			bPartialLumaPyramid,
+			LumaMip0Texture,
 			GraphBuilder,
 			workgroupCount,
 			ArmASRInfo);
 
 		FArmASRComputeLuminancePyramidCS::FPermutationDomain PermutationVector;
-		const ERHIFeatureSupport WaveOpsSupport = FDataDrivenShaderPlatformInfo::GetSupportsWaveOperations(View.GetShaderPlatform());
-		const bool bUseWaveOps = (WaveOpsSupport == ERHIFeatureSupport::RuntimeGuaranteed) ||
-								 (WaveOpsSupport == ERHIFeatureSupport::RuntimeDependent && GRHISupportsWaveOperations);
-		PermutationVector.Set<FArmASR_UseWaveOps>(bUseWaveOps);
+		PermutationVector.Set<FArmASR_UseWaveOps>(ShouldUseWaveOps(View.GetShaderPlatform()));
+		PermutationVector.Set<FArmASR_SpdSubgroupReduction>(GetSpdSubgroupReductionWidth(View.GetShaderPlatform(), CVarArmASRSpdSubgroupReduction.GetValueOnRenderThread() != 0));
+		PermutationVector.Set<FArmASR_PartialLumaPyramid>(bPartialLumaPyramid);
+		PermutationVector.Set<FArmASR_FusedLumaMip>(LumaMip0Texture != nullptr);
 		TShaderMapRef<FArmASRComputeLuminancePyramidCS> ClpShader(ViewInfo.ShaderMap, PermutationVector);
 		FComputeShaderUtils::AddPass(
 			GraphBuilder,
@@ -553,6 +1055,10 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 			ClpShaderParameters,
 			workgroupCount
 		);
+	};
+	if (!bIsUltraPerformance && !bFusedLumaMip)
+	{
+		AddComputeLuminancePyramidPass(nullptr);
 	}
 
 	// If AutoExposure is enabled use Exposure generated from Compute Luminance shader, otherwise use Engine exposure.
@@ -588,12 +1094,15 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	{
 		SetReconstructPrevDepthParameters(
 			bIsUltraPerformance,
+			bRecomputePreparedInputs,
+			bHalfResPrevDepth,
 			RpdShaderParameters,
 			ArmASRPassParametersBuffer,
 			MotionVectorTextureNew,
 			DepthTexture,
 			SceneColorTexture,
 			AutoExposureTexture, // Generated from Compute Luminance Pyramid or Unreal Engine
+			EpochTaggedNearestDepthTexture,
 			InputExtents,
 			InputViewport,
 			GraphBuilder);
@@ -601,6 +1110,10 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 		// Create shader and add pass.
 		FArmASRReconstructPrevDepthPS::FPermutationDomain PermutationVector;
 		PermutationVector.Set<FArmASR_ApplyUltraPerfOpt>(bIsUltraPerformance);
+		PermutationVector.Set<FArmASR_RecomputePreparedInputs>(bRecomputePreparedInputs);
+		PermutationVector.Set<FArmASR_GatherNearestDepth>(bGatherNearestDepth);
+		PermutationVector.Set<FArmASR_EpochTaggedPrevDepth>(bEpochTaggedPrevDepth);
+		PermutationVector.Set<FArmASR_HalfResPrevDepth>(bHalfResPrevDepth);
 		TShaderMapRef<FArmASRReconstructPrevDepthPS> RpdShader(ViewInfo.ShaderMap, PermutationVector);
 		FPixelShaderUtils::AddFullscreenPass(
 			GraphBuilder, ViewInfo.ShaderMap,
@@ -628,62 +1141,130 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 			DilatedDepthMotionVectorsInputLumaTexture,
 			PrevDilatedDepthMotionVectorsInputLuma,
 			MotionVectorTextureNew,
-			ReactiveMaskTexture,
-			CompositeMaskTexture,
+			ReactiveAndCompositeMaskTexture,
 			DepthTexture,
 			SceneColorTexture,
 			QualityPreset,
+			bRecomputePreparedInputs,
+			bFusedLumaMip,
+			bComputeDepthClip,
 			InputExtents,
 			InputViewport,
 			GraphBuilder);
 
-		FArmASRDepthClipPS::FPermutationDomain PermutationVector;
-		// Depth clip applies optimizations for the Performance preset
-		PermutationVector.Set<FArmASR_ApplyBalancedOpt>(bIsBalancedOrPerformance);
-		PermutationVector.Set<FArmASR_ApplyPerfOpt>(bIsPerformance);
-		PermutationVector.Set<FArmASR_ApplyUltraPerfOpt>(bIsUltraPerformance);
-		TShaderMapRef<FArmASRDepthClipPS> DcShader(ViewInfo.ShaderMap, PermutationVector);
-		FPixelShaderUtils::AddFullscreenPass(
-			GraphBuilder, ViewInfo.ShaderMap,
-			RDG_EVENT_NAME("Depth Clip (PS)"),
-			DcShader,
-			DcShaderParameters,
-			InputViewport.Rect);
+		if (bComputeDepthClip)
+		{
+			if (ComputeGroupSizeBeginQuery)
+			{
+				AddTimestampPass(GraphBuilder, ComputeGroupSizeBeginQuery);
+			}
+			if (ComputePassBeginQuery)
+			{
+				AddTimestampPass(GraphBuilder, ComputePassBeginQuery);
+			}
+
+			FArmASRDepthClipCS::FParameters* DcCSShaderParameters = GraphBuilder.AllocParameters<FArmASRDepthClipCS::FParameters>();
+			SetDepthClipCSParameters(DcCSShaderParameters, DcShaderParameters, bRecomputePreparedInputs, GraphBuilder);
+
+			FArmASRDepthClipCS::FPermutationDomain PermutationVector;
+			PermutationVector.Set<FArmASR_ApplyBalancedOpt>(bIsBalancedOrPerformance);
+			PermutationVector.Set<FArmASR_ApplyPerfOpt>(bIsPerformance);
+			PermutationVector.Set<FArmASR_ApplyUltraPerfOpt>(bIsUltraPerformance);
+			PermutationVector.Set<FArmASR_RecomputePreparedInputs>(bRecomputePreparedInputs);
+			PermutationVector.Set<FArmASR_EpochTaggedPrevDepth>(bEpochTaggedPrevDepth);
+			PermutationVector.Set<FArmASR_HalfResPrevDepth>(bHalfResPrevDepth);
+			PermutationVector.Set<FArmASR_ComputeGroupSize>(ComputeGroupSizeIndex);
+			TShaderMapRef<FArmASRDepthClipCS> DcCSShader(ViewInfo.ShaderMap, PermutationVector);
+			FComputeShaderUtils::AddPass(
+				GraphBuilder,
+				RDG_EVENT_NAME("Depth Clip (CS)"),
+				DcCSShader,
+				DcCSShaderParameters,
+				FComputeShaderUtils::GetGroupCount(InputViewport.Rect.Size(), ComputeGroupSize));
+			if (DepthClipEndQuery)
+			{
+				AddTimestampPass(GraphBuilder, DepthClipEndQuery);
+			}
+		}
+		else
+		{
+			FArmASRDepthClipPS::FPermutationDomain PermutationVector;
+			// Depth clip applies optimizations for the Performance preset
+			PermutationVector.Set<FArmASR_ApplyBalancedOpt>(bIsBalancedOrPerformance);
+			PermutationVector.Set<FArmASR_ApplyPerfOpt>(bIsPerformance);
+			PermutationVector.Set<FArmASR_ApplyUltraPerfOpt>(bIsUltraPerformance);
+			PermutationVector.Set<FArmASR_RecomputePreparedInputs>(bRecomputePreparedInputs);
+			PermutationVector.Set<FArmASR_FusedLumaMip>(bFusedLumaMip);
+			PermutationVector.Set<FArmASR_EpochTaggedPrevDepth>(bEpochTaggedPrevDepth);
+			PermutationVector.Set<FArmASR_HalfResPrevDepth>(bHalfResPrevDepth);
+			PermutationVector.Set<FArmASR_QuadShuffleNeighborhood>(ShouldUseWaveOps(View.GetShaderPlatform()));
+			TShaderMapRef<FArmASRDepthClipPS> DcShader(ViewInfo.ShaderMap, PermutationVector);
+			FPixelShaderUtils::AddFullscreenPass(
+				GraphBuilder, ViewInfo.ShaderMap,
+				RDG_EVENT_NAME("Depth Clip (PS)"),
+				DcShader,
+				DcShaderParameters,
+				InputViewport.Rect);
+		}
+	}
+
+	if (bFusedLumaMip)
+	{
+		AddComputeLuminancePyramidPass(DcShaderParameters->rw_luma_mip_0->Desc.Texture);
 	}
 
 	// Lock Shader
 	// -----------
-	FRDGTextureRef LockInputLumaTexture = bIsUltraPerformance ? nullptr : RpdShaderParameters->RenderTargets[2].GetTexture();
+	FRDGTextureRef LockInputLumaTexture = (bIsUltraPerformance || bRecomputePreparedInputs) ? nullptr : RpdShaderParameters->RenderTargets[2].GetTexture();
 	FArmASRLockCS::FParameters* LShaderParameters = GraphBuilder.AllocParameters<FArmASRLockCS::FParameters>();
 	{
 		SetLockParameters(
 			bIsUltraPerformance,
+			bRecomputePreparedInputs,
 			LShaderParameters,
 			ArmASRPassParametersBuffer,
 			LockInputLumaTexture, // Generated RT from Reconstruct Prev Depth
 			DilatedDepthMotionVectorsInputLumaTexture,
+			SceneColorTexture,
+			AutoExposureTexture,
 			NewLock,
-			OutputExtents,
+			HistoryExtents,
 			GraphBuilder
 		);
 		FArmASRLockCS::FPermutationDomain PermutationVector;
 		PermutationVector.Set<FArmASR_ApplyUltraPerfOpt>(bIsUltraPerformance);
+		PermutationVector.Set<FArmASR_RecomputePreparedInputs>(bRecomputePreparedInputs);
+		PermutationVector.Set<FArmASR_GroupsharedNeighborhood>(bGroupsharedNeighborhood);
+		PermutationVector.Set<FArmASR_ComputeGroupSize>(ComputeGroupSizeIndex);
 		TShaderMapRef<FArmASRLockCS> LShader(ViewInfo.ShaderMap, PermutationVector);
+		if (ComputeGroupSizeBeginQuery && !bComputeDepthClip)
+		{
+			AddTimestampPass(GraphBuilder, ComputeGroupSizeBeginQuery);
+		}
 		FComputeShaderUtils::AddPass(
 			GraphBuilder,
 			RDG_EVENT_NAME("Lock (CS)"),
 			LShader,
 			LShaderParameters,
-			FComputeShaderUtils::GetGroupCount(Inputs.SceneColor.ViewRect.Size(), FComputeShaderUtils::kGolden2DGroupSize)
+			FComputeShaderUtils::GetGroupCount(Inputs.SceneColor.ViewRect.Size(), ComputeGroupSize)
 		);
+		if (ComputeGroupSizeEndQuery)
+		{
+			AddTimestampPass(GraphBuilder, ComputeGroupSizeEndQuery);
+		}
+		if (LockEndQuery)
+		{
+			AddTimestampPass(GraphBuilder, LockEndQuery);
+		}
 	}
 
 	// Accumulate Shader
 	// -----------------
 	FRDGTextureRef ImgMipShadingChangeTexture = bIsUltraPerformance ? nullptr : ClpShaderParameters->rw_img_mip_shading_change->Desc.Texture;
 	FArmASRAccumulatePS::FParameters* AccumulateParameters = GraphBuilder.AllocParameters<FArmASRAccumulatePS::FParameters>();
+	FArmASRAccumulateHistory AccumulateHistory;
 	{
-		SetAccumulateParameters(
+		AccumulateHistory = SetAccumulateParameters(
 			AccumulateParameters,
 			ArmASRPassParametersBuffer,
 			AutoExposureTexture,							   // Generated from Compute Luminance Pyramid or Unreal Engine
@@ -691,7 +1272,7 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 			DilatedMotionVectorTexture,						   // Dilated Motion vector is generated from Reconstruct Prev Depth
 			DilatedDepthMotionVectorsInputLumaTexture,
 			DcShaderParameters->RenderTargets[0].GetTexture(), // Dilated Reactive Mask is generated from Depth clip
-			DcShaderParameters->RenderTargets[1].GetTexture(), // Prepared input colour is generated from Depth clip
+			DcShaderParameters->RenderTargets[1].GetTexture(), // Prepared input colour (or only the depth clip) is generated from Depth clip
 			SceneColorTexture,
 			PrevLockStatus,
 			Outputs.FullRes.Texture,
@@ -700,18 +1281,46 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 			PrevLumaHistory,
 			PrevInternalReactive,
 			LShaderParameters->rw_new_locks->Desc.Texture, // Generated from Lock
-			Sharpness,
+			bUseRCAS,
 			QualityPreset,
-			OutputExtents,
-			OutputViewport.Rect,
+			bUseCompactHistory,
+			bRenderResAuxHistory,
+			bUseLumaMoments,
+			bRecomputePreparedInputs,
+			InputExtents,
+			HistoryExtents,
+			HistoryViewport.Rect,
 			GraphBuilder);
 
 		FArmASRAccumulatePS::FPermutationDomain PermutationVector;
-		PermutationVector.Set<FArmASR_DoSharpening>(bApplySharpening);
+		// No separate output target when RCAS writes the output or the output is the history.
+		PermutationVector.Set<FArmASR_DoSharpening>(bUseRCAS || bOutputAliasesHistory);
 		// Choose the correct permutation based on quality preset
 		PermutationVector.Set<FArmASR_ApplyBalancedOpt>(bIsBalancedOrPerformance ? 1 : 0);
 		PermutationVector.Set<FArmASR_ApplyPerfOpt>(bIsPerformance ? 1 : 0);
 		PermutationVector.Set<FArmASR_ApplyUltraPerfOpt>(bIsUltraPerformance ? 1 : 0);
+		PermutationVector.Set<FArmASR_CompactHistory>(bUseCompactHistory);
+		PermutationVector.Set<FArmASR_RenderResAuxHistory>(bRenderResAuxHistory);
+		PermutationVector.Set<FArmASR_LumaMoments>(bUseLumaMoments);
+		PermutationVector.Set<FArmASR_LanczosReprojection>(bUseLanczosReprojection);
+		const int32 UpscaleRatio = (bExperimentalPermutations && CVarArmASRRatioSpecializedShaders.GetValueOnRenderThread()) ? GetSpecializedUpscaleRatio(InputExtents, HistoryExtents) : 0;
+		// The table holds the phases of the engine's Halton jitter sequence, a view with any other jitter evaluates the weights.
+		const bool bUseUpsampleWeightTable = (UpscaleRatio != 0) && CVarArmASRUpsampleWeightTable.GetValueOnRenderThread() &&
+			GetArmASRJitter(ViewInfo.TemporalJitterIndex).Equals(ArmASRPassParameters->fJitter, 1e-4f);
+		if (bUseUpsampleWeightTable)
+		{
+			AccumulateParameters->r_upsample_weights = GetUpsampleWeightTable(GraphBuilder, UpsampleWeightTable, UpscaleRatio, ViewInfo.TemporalJitterSequenceLength);
+		}
+		const bool bUseLanczosLut = bExperimentalPermutations && !bUseUpsampleWeightTable && CVarArmASRLanczosLut.GetValueOnRenderThread();
+		if (bUseLanczosLut)
+		{
+			AccumulateParameters->r_lanczos_lut = GetLanczosLutTexture(GraphBuilder, ArmASRInfo);
+		}
+		PermutationVector.Set<FArmASR_UpscaleRatio>(UpscaleRatio);
+		PermutationVector.Set<FArmASR_UpsampleWeightTable>(bUseUpsampleWeightTable);
+		PermutationVector.Set<FArmASR_LanczosLut>(bUseLanczosLut);
+		PermutationVector.Set<FArmASR_RecomputePreparedInputs>(bRecomputePreparedInputs);
+		PermutationVector.Set<FArmASR_PartialLumaPyramid>(bPartialLumaPyramid);
 
 		TShaderMapRef<FArmASRAccumulatePS> AccumulateShader(ViewInfo.ShaderMap, PermutationVector);
 		FPixelShaderUtils::AddFullscreenPass(
@@ -719,11 +1328,16 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 			RDG_EVENT_NAME("Accumulate (PS)"),
 			AccumulateShader,
 			AccumulateParameters,
-			OutputViewport.Rect);
+			HistoryViewport.Rect);
+
+		if (bOutputAliasesHistory)
+		{
+			Outputs.FullRes.Texture = AccumulateHistory.UpscaledColour;
+		}
 	}
 
-	// Add RCAS if necessary
-	if (Sharpness > 0.0f)
+	// Add RCAS if necessary. It also upsamples a reduced-resolution history to the output.
+	if (bUseRCAS)
 	{
 		FArmASRRCASPS::FParameters* RcasParameters = GraphBuilder.AllocParameters<FArmASRRCASPS::FParameters>();
 		FArmASRRCASParameters* rcasPassParameters = GraphBuilder.AllocParameters<FArmASRRCASParameters>();
@@ -735,10 +1349,14 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 			AccumulateParameters->RenderTargets[0].GetTexture(),
 			Outputs.FullRes.Texture,
 			Sharpness,
+			bUpsampleHistory,
 			OutputViewport.Rect,
 			GraphBuilder);
 
-		TShaderMapRef<FArmASRRCASPS> RcasShader(ViewInfo.ShaderMap);
+		FArmASRRCASPS::FPermutationDomain PermutationVector;
+		PermutationVector.Set<FArmASR_RcasUpsample>(bUpsampleHistory);
+
+		TShaderMapRef<FArmASRRCASPS> RcasShader(ViewInfo.ShaderMap, PermutationVector);
 		FPixelShaderUtils::AddFullscreenPass(
 			GraphBuilder, ViewInfo.ShaderMap,
 			RDG_EVENT_NAME("RCAS (PS)"),
@@ -750,27 +1368,26 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	// Set up new history
 	TRefCountPtr<FArmASRTemporalAAHistory> NewHistory(new FArmASRTemporalAAHistory());
 
-	if (!bIsQuality)
+	if (AccumulateHistory.TemporalReactive)
 	{
-		NewHistory->LumaHistory = nullptr;
-		const int32 TemporalReactiveIdx = (!bIsQuality) ? 1 : -1;
-		FRDGTextureRef TemporalReactiveTexture = AccumulateParameters->RenderTargets[TemporalReactiveIdx].GetTexture();
-		GraphBuilder.QueueTextureExtraction(TemporalReactiveTexture, &NewHistory->InternalReactive);
+		GraphBuilder.QueueTextureExtraction(AccumulateHistory.TemporalReactive, &NewHistory->InternalReactive);
 	}
 	else
 	{
 		NewHistory->InternalReactive = nullptr;
-		FRDGTextureRef LumaHistoryTexture = AccumulateParameters->RenderTargets[2].GetTexture();
-		GraphBuilder.QueueTextureExtraction(LumaHistoryTexture, &NewHistory->LumaHistory);
 	}
 
-	const int32 LockStatusIdx = bIsUltraPerformance ? 1 : (bIsBalancedOrPerformance ? 2 : 1);
-	FRDGTextureRef InternalUpscaledColor = AccumulateParameters->RenderTargets[0].GetTexture();
-	FRDGTextureRef LockStatusTexture = AccumulateParameters->RenderTargets[LockStatusIdx].GetTexture();
+	if (AccumulateHistory.LumaHistory)
+	{
+		GraphBuilder.QueueTextureExtraction(AccumulateHistory.LumaHistory, &NewHistory->LumaHistory);
+	}
+	else
+	{
+		NewHistory->LumaHistory = nullptr;
+	}
 
-	GraphBuilder.QueueTextureExtraction(NewLock, &NewHistory->NewLock);
-	GraphBuilder.QueueTextureExtraction(InternalUpscaledColor, &NewHistory->UpscaledColour);
-	GraphBuilder.QueueTextureExtraction(LockStatusTexture, &NewHistory->LockStatus);
+	GraphBuilder.QueueTextureExtraction(AccumulateHistory.UpscaledColour, &NewHistory->UpscaledColour);
+	GraphBuilder.QueueTextureExtraction(AccumulateHistory.LockStatus, &NewHistory->LockStatus);
 	if (bIsUltraPerformance)
 	{
 		GraphBuilder.QueueTextureExtraction(DilatedDepthMotionVectorsInputLumaTexture, &NewHistory->DilatedDepthMotionVectorsInputLuma);
@@ -779,10 +1396,55 @@ UE::Renderer::Private::ITemporalUpscaler::FOutputs FArmASRTemporalUpscaler::AddP
 	{
 		GraphBuilder.QueueTextureExtraction(DilatedMotionVectorTexture, &NewHistory->DilatedMotionVectors);
 	}
+	if (bEpochTaggedPrevDepth)
+	{
+		GraphBuilder.QueueTextureExtraction(RpdShaderParameters->rw_reconstructed_previous_nearest_depth->Desc.Texture, &NewHistory->ReconstructedPrevNearestDepth);
+		NewHistory->ReconstructedDepthEpoch = ArmASRPassParameters->uReconstructedDepthEpoch;
+	}
 	NewHistory->PreExposure = ArmASRPassParameters->fPreExposure;
+	NewHistory->UpsampleWeightTable = MoveTemp(UpsampleWeightTable);
 
 	Outputs.NewHistory = NewHistory;
 
+	if (CVarArmASRReportUncompressedSurfaces.GetValueOnRenderThread())
+	{
+		TArray<FRDGTextureRef, TInlineAllocator<16>> Surfaces = {
+			Outputs.FullRes.Texture,
+			NewLock,
+			MotionVectorTextureNew,
+			ExposureTexture,
+			ImgMipShadingChangeTexture,
+			RpdShaderParameters->rw_reconstructed_previous_nearest_depth->Desc.Texture,
+			AccumulateHistory.LockStatus,
+			AccumulateHistory.TemporalReactive,
+		};
+		for (int32 Index = 0; Index < MaxSimultaneousRenderTargets; ++Index)
+		{
+			Surfaces.AddUnique(RpdShaderParameters->RenderTargets[Index].GetTexture());
+			Surfaces.AddUnique(DcShaderParameters->RenderTargets[Index].GetTexture());
+			Surfaces.AddUnique(AccumulateParameters->RenderTargets[Index].GetTexture());
+		}
+		// Every UAV the passes bind, which also covers the persistent SPD atomic and the surfaces only some modes create.
+		const FRDGTextureUAVRef UAVs[] = {
+			ClpShaderParameters->rw_spd_global_atomic,
+			ClpShaderParameters->rw_img_mip_shading_change,
+			ClpShaderParameters->rw_img_mip_5,
+			ClpShaderParameters->rw_auto_exposure,
+			DcShaderParameters->rw_luma_mip_0,
+			LShaderParameters->rw_new_locks,
+			AccumulateParameters->rw_render_res_lock_status,
+			AccumulateParameters->rw_render_res_temporal_reactive,
+		};
+		for (FRDGTextureUAVRef UAV : UAVs)
+		{
+			if (UAV)
+			{
+				Surfaces.AddUnique(UAV->Desc.Texture);
+			}
+		}
+		NewHistory->UncompressedSurfacesReport = ReportUncompressedSurfaces(Surfaces, PrevHistory ? PrevHistory->UncompressedSurfacesReport : FString());
+	}
+
 	return Outputs;
 }
 
@@ -67,7 +67,8 @@ void ArmASRFXSystem::PostRenderOpaque(FRDGBuilder& GraphBuilder, TConstStridedVi
 
 		FRDGTextureDesc SceneColorPreAlphaCreateDesc = FRDGTextureDesc::Create2D(
 			FIntPoint(QuantizedSize.X, QuantizedSize.Y), SceneColorFormat, FClearValueBinding::Black, ETextureCreateFlags::RenderTargetable | ETextureCreateFlags::ShaderResource, 1, NumSamples);
-		Info.SceneColorPreAlpha = GraphBuilder.CreateTexture(SceneColorPreAlphaCreateDesc, TEXT("ArmASRSceneColorPreAlphaTexture"), ERDGTextureFlags::MultiFrame);
+		// Only read by the reactive mask pass later in the same graph, so let RDG alias it once that pass is done.
+		Info.SceneColorPreAlpha = GraphBuilder.CreateTexture(SceneColorPreAlphaCreateDesc, TEXT("ArmASRSceneColorPreAlphaTexture"));
 
 		AddCopyTexturePass(GraphBuilder, PreAlpha.Target, Info.SceneColorPreAlpha, FIntPoint::ZeroValue, FIntPoint::ZeroValue, View.ViewRect.Size());
 	}
@@ -16,6 +16,50 @@ struct FArmASRResource
 	FTextureRHIRef Texture;
 };
 
+// Per device choice of the thread group size of the 2D compute passes, see r.ArmASR.ComputeGroupSize.
+struct FArmASRComputeGroupSizeTuning
+{
+	// FArmASR_ComputeGroupSize index to use, INDEX_NONE while the candidates are being timed.
+	int32 Selected = INDEX_NONE;
+	// User config key of the device, the winner is stored under it.
+	FString DeviceKey;
+
+	struct FPendingTiming
+	{
+		FRHIPooledRenderQuery Begin;
+		FRHIPooledRenderQuery End;
+		int32 Candidate;
+	};
+
+	uint32 FrameIndex = 0;
+	FRenderQueryPoolRHIRef QueryPool;
+	TArray<FPendingTiming> Pending;
+	// Microseconds, per candidate.
+	TArray<TArray<uint64>> Samples;
+};
+
+// GPU times of the compute Depth Clip and Lock passes, see r.ArmASR.ComputePassTimings.
+struct FArmASRComputePassTimings
+{
+	struct FPendingTiming
+	{
+		FRHIPooledRenderQuery Begin;
+		FRHIPooledRenderQuery DepthClipEnd;
+		FRHIPooledRenderQuery LockEnd;
+		int32 GroupSwizzle;
+		int32 ComputeGroupSize;
+	};
+
+	FRenderQueryPoolRHIRef QueryPool;
+	TArray<FPendingTiming> Pending;
+	// r.ArmASR.GroupSwizzle and FArmASR_ComputeGroupSize index the samples were measured with.
+	int32 GroupSwizzle = INDEX_NONE;
+	int32 ComputeGroupSize = INDEX_NONE;
+	// Microseconds, per pass.
+	TArray<uint64> DepthClipSamples;
+	TArray<uint64> LockSamples;
+};
+
 struct FArmASRInfo
 {
 	FPostProcessingInputs PostInputs;
@@ -25,6 +69,11 @@ struct FArmASRInfo
 
 	// Defaultly not set
 	TOptional<FArmASRResource> Atomic = TOptional<FArmASRResource>();
+	TOptional<FArmASRResource> LanczosLut = TOptional<FArmASRResource>();
+
+	// Kept for the lifetime of the plugin, the choice does not depend on the frame.
+	FArmASRComputeGroupSizeTuning ComputeGroupSizeTuning;
+	FArmASRComputePassTimings ComputePassTimings;
 };
 
 // Free up per frame information at the end of the frame.
@@ -36,16 +85,22 @@ inline void CleanUpArmASRInfoFrameInfo(FArmASRInfo& Info)
 	Info.ReflectionTexture = nullptr;
 }
 
+inline void CleanUpArmASRResource(TOptional<FArmASRResource>& Resource)
+{
+	if (Resource)
+	{
+		Resource.GetValue().Texture.SafeRelease();
+		Resource.GetValue().RenderTarget.SafeRelease();
+		Resource.Reset();
+	}
+}
+
 // Clean up all information. 
 // ArmASR has some static data which we only upload to the GPU once and it is reused every frame.
 // If ArmASR has been disabled then we should clean this up.
 inline void CleanUpArmASRInfoAll(FArmASRInfo& Info)
 {
 	CleanUpArmASRInfoFrameInfo(Info);
-	if (Info.Atomic)
-	{
-		Info.Atomic.GetValue().Texture.SafeRelease();
-		Info.Atomic.GetValue().RenderTarget.SafeRelease();
-		Info.Atomic.Reset();
-	}
+	CleanUpArmASRResource(Info.Atomic);
+	CleanUpArmASRResource(Info.LanczosLut);
 }
\ No newline at end of file
@@ -29,11 +29,160 @@
 #include "SystemTextures.h"
 
 class FArmASR_DoSharpening : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_APPLY_SHARPENING");
+class FArmASR_CompactHistory : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_COMPACT_HISTORY");
+class FArmASR_RenderResAuxHistory : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_RENDER_RES_AUX_HISTORY");
+class FArmASR_LumaMoments : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_LUMA_MOMENTS");
+class FArmASR_LanczosReprojection : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_REPROJECT_LANCZOS_BILINEAR");
+class FArmASR_UpscaleRatio : SHADER_PERMUTATION_INT("FFXM_FSR2_OPTION_UPSCALE_RATIO", 5);
+class FArmASR_UpsampleWeightTable : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_UPSAMPLE_WEIGHT_TABLE");
+class FArmASR_LanczosLut : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_LANCZOS_LUT");
+
+// Platforms that only guarantee 4 simultaneous render targets: OpenGL ES, Android, and the mobile Vulkan and Metal ones.
+inline bool IsAccumulateLimitedToFourTargets(const FStaticShaderPlatform Platform)
+{
+	return IsMobilePlatform(Platform) || IsAndroidPlatform(Platform);
+}
+
+// Upscale ratios with a specialized Accumulate permutation, in FFXM_FSR2_OPTION_UPSCALE_RATIO order after the generic 0.
+static const float ARM_ASR_SPECIALIZED_UPSCALE_RATIOS[] = { 1.5f, 1.7f, 2.0f, 3.0f };
+// Number of output pixels after which the output to input pixel mapping of each ratio repeats.
+static const int32 ARM_ASR_SPECIALIZED_UPSCALE_PERIODS[] = { 3, 17, 2, 3 };
+
+// Returns the FArmASR_UpscaleRatio permutation for the given extents, or 0 for the generic permutation. A ratio is
+// only used when the fixed factor stays within 1/8 of an input pixel of the real one across the whole output.
+inline int32 GetSpecializedUpscaleRatio(const FIntPoint& InputExtents, const FIntPoint& OutputExtents)
+{
+	for (int32 Index = 0; Index < UE_ARRAY_COUNT(ARM_ASR_SPECIALIZED_UPSCALE_RATIOS); ++Index)
+	{
+		const float DownscaleFactor = 1.0f / ARM_ASR_SPECIALIZED_UPSCALE_RATIOS[Index];
+		const float ErrorX = FMath::Abs(DownscaleFactor * OutputExtents.X - InputExtents.X);
+		const float ErrorY = FMath::Abs(DownscaleFactor * OutputExtents.Y - InputExtents.Y);
+		if (ErrorX <= 0.125f && ErrorY <= 0.125f)
+		{
+			return Index + 1;
+		}
+	}
+	return 0;
+}
+
+// Halton sequence value of Index in Base, as used by the engine for the temporal jitter.
+inline float ArmASRHalton(int32 Index, const int32 Base)
+{
+	float Result = 0.0f;
+	const float InvBase = 1.0f / Base;
+	float Fraction = InvBase;
+	while (Index > 0)
+	{
+		Result += (Index % Base) * Fraction;
+		Index /= Base;
+		Fraction *= InvBase;
+	}
+	return Result;
+}
+
+// Jitter of the given phase of the engine's temporal jitter sequence, in input pixels.
+inline FVector2f GetArmASRJitter(const int32 JitterPhaseIndex)
+{
+	return FVector2f(ArmASRHalton(JitterPhaseIndex + 1, 2) - 0.5f, ArmASRHalton(JitterPhaseIndex + 1, 3) - 0.5f);
+}
+
+// The upsample weight table of a view, kept in its history until the upscale ratio or jitter sequence changes.
+struct FArmASRUpsampleWeightTable
+{
+	TRefCountPtr<FRDGPooledBuffer> Buffer;
+	int32 UpscaleRatio = 0;
+	int32 JitterPhaseCount = 0;
+};
+
+// Returns the 3x3 upsample Lanczos weights of each jitter phase and output pixel phase for a specialized upscale ratio,
+// matching ComputeUpsampledColorAndWeight for pixels with the widest kernel, and only builds them when Table's key
+// changes. The weights repeat every ARM_ASR_SPECIALIZED_UPSCALE_PERIODS output pixels, so each jitter phase has at most
+// 17x17 entries of 3 float4s.
+inline FRDGBufferSRVRef GetUpsampleWeightTable(FRDGBuilder& GraphBuilder, FArmASRUpsampleWeightTable& Table, const int32 UpscaleRatio, const int32 JitterPhaseCount)
+{
+	check(UpscaleRatio > 0 && UpscaleRatio <= UE_ARRAY_COUNT(ARM_ASR_SPECIALIZED_UPSCALE_RATIOS));
+	if (Table.Buffer && Table.UpscaleRatio == UpscaleRatio && Table.JitterPhaseCount == JitterPhaseCount)
+	{
+		return GraphBuilder.CreateSRV(GraphBuilder.RegisterExternalBuffer(Table.Buffer, TEXT("ArmASRUpsampleWeights")), PF_A32B32G32R32F);
+	}
+
+	const float DownscaleFactor = 1.0f / ARM_ASR_SPECIALIZED_UPSCALE_RATIOS[UpscaleRatio - 1];
+	const int32 Period = ARM_ASR_SPECIALIZED_UPSCALE_PERIODS[UpscaleRatio - 1];
+	// ComputeMaxKernelWeight()
+	const float KernelBias = std::min(1.99f, 1.0f + (1.0f / DownscaleFactor - 1.0f));
+
+	TArray<FVector4f> Weights;
+	Weights.SetNumZeroed(JitterPhaseCount * Period * Period * 3);
+	for (int32 JitterPhase = 0; JitterPhase < JitterPhaseCount; ++JitterPhase)
+	{
+		const FVector2f Jitter = GetArmASRJitter(JitterPhase);
+		for (int32 PhaseY = 0; PhaseY < Period; ++PhaseY)
+		{
+			for (int32 PhaseX = 0; PhaseX < Period; ++PhaseX)
+			{
+				const FVector2f SrcOutputPos = (FVector2f(PhaseX, PhaseY) + 0.5f) * DownscaleFactor;
+				const FVector2f BaseSampleOffset = FVector2f(FMath::FloorToFloat(SrcOutputPos.X), FMath::FloorToFloat(SrcOutputPos.Y)) + 0.5f - Jitter - SrcOutputPos;
+
+				float TapWeights[12] = {};
+				for (int32 Tap = 0; Tap < 9; ++Tap)
+				{
+					const FVector2f Offset = (BaseSampleOffset + FVector2f(Tap % 3 - 1, Tap / 3 - 1)) * KernelBias;
+					TapWeights[Tap] = Lanczos2ApproxSq(Offset.X * Offset.X + Offset.Y * Offset.Y);
+				}
+
+				const int32 Index = ((JitterPhase * Period + PhaseY) * Period + PhaseX) * 3;
+				Weights[Index + 0] = FVector4f(TapWeights[0], TapWeights[1], TapWeights[2], TapWeights[3]);
+				Weights[Index + 1] = FVector4f(TapWeights[4], TapWeights[5], TapWeights[6], TapWeights[7]);
+				Weights[Index + 2] = FVector4f(TapWeights[8], TapWeights[9], TapWeights[10], TapWeights[11]);
+			}
+		}
+	}
+
+	const FRDGBufferDesc WeightsDesc = FRDGBufferDesc::CreateBufferDesc(sizeof(FVector4f), Weights.Num());
+	FRDGBufferRef WeightsBuffer = CreateVertexBuffer(GraphBuilder, TEXT("ArmASRUpsampleWeights"), WeightsDesc, Weights.GetData(), Weights.Num() * sizeof(FVector4f));
+	Table.Buffer = GraphBuilder.ConvertToExternalBuffer(WeightsBuffer);
+	Table.UpscaleRatio = UpscaleRatio;
+	Table.JitterPhaseCount = JitterPhaseCount;
+	return GraphBuilder.CreateSRV(WeightsBuffer, PF_A32B32G32R32F);
+}
+
+// Returns the Lanczos2 lookup texture, uploading it the first time. Texel i holds Lanczos2(x) for x * x = 4 * i / (N - 1),
+// so the shader indexes it with the squared distance it already has and doesn't need a square root.
+inline FRDGTextureSRVRef GetLanczosLutTexture(FRDGBuilder& GraphBuilder, FArmASRInfo& ArmASRInfo)
+{
+	if (!ArmASRInfo.LanczosLut)
+	{
+		TArray<FFloat16> LutValues;
+		LutValues.SetNumUninitialized(ARM_ASR_LANCZOS_LUT_WIDTH);
+		for (int32 Index = 0; Index < ARM_ASR_LANCZOS_LUT_WIDTH; ++Index)
+		{
+			const float DistanceSq = 4.0f * static_cast<float>(Index) / static_cast<float>(ARM_ASR_LANCZOS_LUT_WIDTH - 1);
+			LutValues[Index] = FFloat16(Lanczos2(std::sqrt(DistanceSq)));
+		}
+
+		FArmASRResource LanczosLut;
+		TextureBulkData LutBulkData(LutValues.GetData(), LutValues.Num() * sizeof(FFloat16));
+
+		FRHITextureCreateDesc LutDesc = FRHITextureCreateDesc::Create2D(TEXT("LanczosLutTexture2D"), ARM_ASR_LANCZOS_LUT_WIDTH, 1, PF_R16F);
+		LutDesc.SetBulkData(&LutBulkData);
+		LutDesc.SetNumMips(1);
+		LutDesc.SetInitialState(ERHIAccess::SRVMask);
+		LutDesc.SetNumSamples(1);
+		LutDesc.SetFlags(TexCreate_ShaderResource);
+
+		LanczosLut.Texture = RHICreateTexture(LutDesc);
+		LanczosLut.RenderTarget = CreateRenderTarget(LanczosLut.Texture.GetReference(), TEXT("LanczosLutTextureRT"));
+		ArmASRInfo.LanczosLut = std::move(LanczosLut);
+	}
+
+	FRDGTextureRef LanczosLutTexture = GraphBuilder.RegisterExternalTexture(ArmASRInfo.LanczosLut.GetValue().RenderTarget, TEXT("LanczosLutTexture"));
+	return GraphBuilder.CreateSRV(FRDGTextureSRVDesc::Create(LanczosLutTexture));
+}
 
 class FArmASRAccumulatePS : public FGlobalShader
 {
 public:
-	using FPermutationDomain = TShaderPermutationDomain<FArmASR_DoSharpening, FArmASR_ApplyBalancedOpt, FArmASR_ApplyPerfOpt, FArmASR_ApplyUltraPerfOpt>;
+	using FPermutationDomain = TShaderPermutationDomain<FArmASR_DoSharpening, FArmASR_ApplyBalancedOpt, FArmASR_ApplyPerfOpt, FArmASR_ApplyUltraPerfOpt, FArmASR_CompactHistory, FArmASR_RenderResAuxHistory, FArmASR_LumaMoments, FArmASR_LanczosReprojection, FArmASR_UpscaleRatio, FArmASR_UpsampleWeightTable, FArmASR_LanczosLut, FArmASR_RecomputePreparedInputs, FArmASR_PartialLumaPyramid>;
 
 	DECLARE_GLOBAL_SHADER(FArmASRAccumulatePS);
 	SHADER_USE_PARAMETER_STRUCT(FArmASRAccumulatePS, FGlobalShader);
@@ -51,16 +200,84 @@ public:
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_color_jittered)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_lock_status)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_prepared_input_color)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_depth_clip)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_imgMips)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_auto_exposure)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_luma_history)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_internal_temporal_reactive)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_new_locks)
+		SHADER_PARAMETER_RDG_BUFFER_SRV(Buffer<float4>, r_upsample_weights)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_lanczos_lut)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_render_res_lock_status)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_render_res_temporal_reactive)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		if (!IsArmASRPresetPermutation(PermutationVector))
+		{
+			return false;
+		}
+
+		// Only the preset and sharpening dimensions are compiled unless the project opts in to the experimental options.
+		if (!AreArmASRExperimentalPermutationsEnabled() &&
+			(PermutationVector.Get<FArmASR_CompactHistory>() || PermutationVector.Get<FArmASR_RenderResAuxHistory>() ||
+			PermutationVector.Get<FArmASR_LumaMoments>() || PermutationVector.Get<FArmASR_LanczosReprojection>() ||
+			PermutationVector.Get<FArmASR_UpscaleRatio>() != 0 || PermutationVector.Get<FArmASR_UpsampleWeightTable>() ||
+			PermutationVector.Get<FArmASR_LanczosLut>() || PermutationVector.Get<FArmASR_RecomputePreparedInputs>() ||
+			PermutationVector.Get<FArmASR_PartialLumaPyramid>()))
+		{
+			return false;
+		}
+
+		// The compact history, luma moments and Lanczos reprojection are only options for the Quality preset. The other
+		// presets already use R11G11B10, don't track luma instability and have their own reprojection kernels.
+		if ((PermutationVector.Get<FArmASR_CompactHistory>() || PermutationVector.Get<FArmASR_LumaMoments>() || PermutationVector.Get<FArmASR_LanczosReprojection>()) &&
+			(PermutationVector.Get<FArmASR_ApplyBalancedOpt>() || PermutationVector.Get<FArmASR_ApplyPerfOpt>() || PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>()))
+		{
+			return false;
+		}
+
+		// Ultra Performance always reads the input colour directly.
+		if (PermutationVector.Get<FArmASR_RecomputePreparedInputs>() && PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>())
+		{
+			return false;
+		}
+
+		// Ultra Performance doesn't read the luminance pyramid.
+		if (PermutationVector.Get<FArmASR_PartialLumaPyramid>() && PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>())
+		{
+			return false;
+		}
+
+		// The weight table is indexed by the output pixel phase of a specialized upscale ratio.
+		if (PermutationVector.Get<FArmASR_UpsampleWeightTable>() && PermutationVector.Get<FArmASR_UpscaleRatio>() == 0)
+		{
+			return false;
+		}
+
+		// The weight table already replaces the Lanczos evaluation of most pixels.
+		if (PermutationVector.Get<FArmASR_LanczosLut>() && PermutationVector.Get<FArmASR_UpsampleWeightTable>())
+		{
+			return false;
+		}
+
+		// The render resolution histories are written through pixel shader UAVs.
+		if (PermutationVector.Get<FArmASR_RenderResAuxHistory>() && IsOpenGLPlatform(Parameters.Platform))
+		{
+			return false;
+		}
+
+		// The compact Quality history writes 5 targets when it also writes the output. Where only 4 are guaranteed,
+		// the history is used as the output instead.
+		if (PermutationVector.Get<FArmASR_CompactHistory>() && !PermutationVector.Get<FArmASR_RenderResAuxHistory>() &&
+			!PermutationVector.Get<FArmASR_DoSharpening>() && IsAccumulateLimitedToFourTargets(Parameters.Platform))
+		{
+			return false;
+		}
+
 		return FArmASRGlobalShader::ShouldCompilePermutation(Parameters);
 	}
 
@@ -71,8 +288,17 @@ public:
 	}
 };
 
+// History textures written by the Accumulate pass, to be extracted for the next frame.
+struct FArmASRAccumulateHistory
+{
+	FRDGTextureRef UpscaledColour = nullptr;
+	FRDGTextureRef TemporalReactive = nullptr;  // Balanced/Performance and compact Quality history only
+	FRDGTextureRef LockStatus = nullptr;
+	FRDGTextureRef LumaHistory = nullptr;       // Quality only
+};
+
 // Function to setup Accumulate shader parameters. AccumulateParameters will be updated.
-inline void SetAccumulateParameters(
+inline FArmASRAccumulateHistory SetAccumulateParameters(
 	FArmASRAccumulatePS::FParameters* AccumulateParameters,
 	TUniformBufferRef<FArmASRPassParameters> ArmASRPassParameters,
 	const FRDGTextureSRVRef AutoExposureTexture,        // Generated UAV from CLP shader or Unreal Engine
@@ -80,17 +306,22 @@ inline void SetAccumulateParameters(
 	const FRDGTextureRef DilatedMotionVectorTexture,    // Generated RT from RPD shader
 	const FRDGTextureRef DilatedDepthMotionVectorsInputLumaTexture, // Generated RT from RPD shader
 	const FRDGTextureRef DilatedReactiveMaskTexture,    // Generated RT from DC shader
-	const FRDGTextureRef PreparedInputColor,            // Generated RT from DC shader
+	const FRDGTextureRef PreparedInputColor,            // Generated RT from DC shader, only the depth clip when recomputing prepared inputs
 	const FRDGTextureSRVRef SceneColorTexture,
 	const FRDGTextureRef PrevLockStatusTexture,         // From history
-	const FRDGTextureRef OutputTexture,
+	const FRDGTextureRef OutputTexture,                 // Null when the history is used as the output
 	const FRDGTextureRef MotionVectorTexture,
 	const FRDGTextureRef PrevUpscaledColourTexture,     // From history
 	const FRDGTextureRef PrevLumaHistoryTexture,        // From history
 	const FRDGTextureRef PrevTemporalReactiveTexture,   // From history
 	const FRDGTextureRef LockMaskTexture,               // Generated UAV from L shader
-	const float Sharpness,
+	const bool bUseRCAS,                                // The RCAS pass writes the output instead
 	const EShaderQualityPreset QualityPreset,
+	const bool bCompactHistory,                         // Quality only: R11G11B10 colour history with a separate temporal reactive
+	const bool bRenderResAuxHistory,                    // Lock status and temporal reactive histories at render resolution
+	const bool bLumaMoments,                            // Quality only: luma history as running mean and standard deviation
+	const bool bRecomputePreparedInputs,                // Not for Ultra Performance: recompute the prepared colour from the input colour
+	const FIntPoint& InputExtents,
 	const FIntPoint& OutputExtents,
 	const FIntRect& OutputRect,
 	FRDGBuilder& GraphBuilder)
@@ -122,10 +353,19 @@ inline void SetAccumulateParameters(
 		FRDGTextureSRVRef DilatedMotionVectorSRVTexture = GraphBuilder.CreateSRV(DilatedMotionVectorSRVDesc);
 		AccumulateParameters->r_dilated_motion_vectors = DilatedMotionVectorSRVTexture;
 
-		// Prepared colour is created in Depth Clip shader.
-		FRDGTextureSRVDesc PreparedInputColorSRVDesc = FRDGTextureSRVDesc::Create(PreparedInputColor);
-		FRDGTextureSRVRef PreparedInputSRVTexture = GraphBuilder.CreateSRV(PreparedInputColorSRVDesc);
-		AccumulateParameters->r_prepared_input_color = PreparedInputSRVTexture;
+		if (bRecomputePreparedInputs)
+		{
+			// Only the depth clip is created in Depth Clip shader, the prepared colour is recomputed.
+			AccumulateParameters->r_input_color_jittered = SceneColorTexture;
+			AccumulateParameters->r_depth_clip = GraphBuilder.CreateSRV(FRDGTextureSRVDesc::Create(PreparedInputColor));
+		}
+		else
+		{
+			// Prepared colour is created in Depth Clip shader.
+			FRDGTextureSRVDesc PreparedInputColorSRVDesc = FRDGTextureSRVDesc::Create(PreparedInputColor);
+			FRDGTextureSRVRef PreparedInputSRVTexture = GraphBuilder.CreateSRV(PreparedInputColorSRVDesc);
+			AccumulateParameters->r_prepared_input_color = PreparedInputSRVTexture;
+		}
 
 		// r_luma_history
 		FRDGTextureSRVDesc LumaHistorySRVDesc = FRDGTextureSRVDesc::Create(PrevLumaHistoryTexture);
@@ -171,51 +411,70 @@ inline void SetAccumulateParameters(
 	AccumulateParameters->r_new_locks = GraphBuilder.CreateSRV(LockMaskSRVDesc);
 
 	const bool bIsBalancedOrPerformance = (QualityPreset == EShaderQualityPreset::BALANCED) || (QualityPreset == EShaderQualityPreset::PERFORMANCE);
-	const EPixelFormat InternalUpscaledFormat = (bIsUltraPerformance || bIsBalancedOrPerformance) ? PF_FloatR11G11B10 : PF_FloatRGBA;
+	const bool bSeparateTemporalReactive = bIsBalancedOrPerformance || bCompactHistory;
+	const FIntPoint AuxHistoryExtents = bRenderResAuxHistory ? InputExtents : OutputExtents;
+	const ETextureCreateFlags AuxHistoryFlags = TexCreate_ShaderResource | (bRenderResAuxHistory ? TexCreate_UAV : TexCreate_RenderTargetable);
+	const EPixelFormat InternalUpscaledFormat = (bIsUltraPerformance || bIsBalancedOrPerformance || bCompactHistory) ? PF_FloatR11G11B10 : PF_FloatRGBA;
 
 	// Create textures for all RenderTargets
 	FRDGTextureDesc InternalUpscaledOutputColorDesc = FRDGTextureDesc::Create2D(OutputExtents, InternalUpscaledFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
 	FRDGTextureRef InternalUpscaledColorOutputTexture = GraphBuilder.CreateTexture(InternalUpscaledOutputColorDesc, TEXT("InternalUpscaledColorOutputTexture"));
 
-	FRDGTextureDesc LockStatusOutputDesc = FRDGTextureDesc::Create2D(OutputExtents, PF_G16R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
+	FRDGTextureDesc LockStatusOutputDesc = FRDGTextureDesc::Create2D(AuxHistoryExtents, PF_G16R16F, FClearValueBinding::Black, AuxHistoryFlags, 1, 1);
 	FRDGTextureRef LockStatusOutputTexture = GraphBuilder.CreateTexture(LockStatusOutputDesc, TEXT("LockStatusOutputTexture"));
 
-	// Create RenderTargets and assign to parameters.
-	const FScreenPassRenderTarget InternalUpscaledColorRT(InternalUpscaledColorOutputTexture, OutputRect, ERenderTargetLoadAction::ENoAction);
-	const FScreenPassRenderTarget LockStatusRT(LockStatusOutputTexture, OutputRect, ERenderTargetLoadAction::ENoAction);
-	const FScreenPassRenderTarget UpscaledOutput(OutputTexture, OutputRect, ERenderTargetLoadAction::ENoAction);
+	FArmASRAccumulateHistory History;
+	History.UpscaledColour = InternalUpscaledColorOutputTexture;
+	History.LockStatus = LockStatusOutputTexture;
 
-	AccumulateParameters->RenderTargets[0] = InternalUpscaledColorRT.GetRenderTargetBinding();
-	if (bIsUltraPerformance)
+	if (bSeparateTemporalReactive)
 	{
-		AccumulateParameters->RenderTargets[1] = LockStatusRT.GetRenderTargetBinding();
+		// UE5 doesn't expose R8_SNorm.
+		const FRDGTextureDesc TemporalReactiveOutputDesc = FRDGTextureDesc::Create2D(AuxHistoryExtents, PF_R16F, FClearValueBinding::Black, AuxHistoryFlags, 1, 1);
+		History.TemporalReactive = GraphBuilder.CreateTexture(TemporalReactiveOutputDesc, TEXT("InternalReactiveOutput"));
 	}
-	else if (!bIsBalancedOrPerformance)
+
+	if (!bIsUltraPerformance && !bIsBalancedOrPerformance)
 	{
-		AccumulateParameters->RenderTargets[1] = LockStatusRT.GetRenderTargetBinding();
+		const EPixelFormat LumaHistoryFormat = bLumaMoments ? PF_R8G8 : PF_R8G8B8A8;
+		FRDGTextureDesc LumaHistoryOutputDesc = FRDGTextureDesc::Create2D(OutputExtents, LumaHistoryFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
+		History.LumaHistory = GraphBuilder.CreateTexture(LumaHistoryOutputDesc, TEXT("LumaHistoryOutputTexture"));
+	}
+
+	// Assign RenderTargets to parameters, in the order of AccumulateOutputsFS.
+	int32 NextIndex = 0;
+	AccumulateParameters->RenderTargets[NextIndex++] = FScreenPassRenderTarget(History.UpscaledColour, OutputRect, ERenderTargetLoadAction::ENoAction).GetRenderTargetBinding();
 
-		FRDGTextureDesc LumaHistoryOutputDesc = FRDGTextureDesc::Create2D(OutputExtents, PF_R8G8B8A8, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
-		FRDGTextureRef LumaHistoryOutputTexture = GraphBuilder.CreateTexture(LumaHistoryOutputDesc, TEXT("LumaHistoryOutputTexture"));
-		const FScreenPassRenderTarget LumaHistoryRT(LumaHistoryOutputTexture, OutputRect, ERenderTargetLoadAction::ENoAction);
-		AccumulateParameters->RenderTargets[2] = LumaHistoryRT.GetRenderTargetBinding();
+	if (bRenderResAuxHistory)
+	{
+		// Every render pixel is written exactly once by the Accumulate pass, so these don't need clearing.
+		AccumulateParameters->rw_render_res_lock_status = GraphBuilder.CreateUAV(History.LockStatus);
+		if (History.TemporalReactive)
+		{
+			AccumulateParameters->rw_render_res_temporal_reactive = GraphBuilder.CreateUAV(History.TemporalReactive);
+		}
 	}
 	else
 	{
-		// UE5 doesn't expose R8_SNorm.
-		const FRDGTextureDesc TemporalReactiveOutputDesc = FRDGTextureDesc::Create2D(OutputExtents, PF_R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
-		const FRDGTextureRef TemporalReactiveOutputTexture = GraphBuilder.CreateTexture(TemporalReactiveOutputDesc, TEXT("InternalReactiveOutput"));
-		const FScreenPassRenderTarget TemporalReactiveRT(TemporalReactiveOutputTexture, OutputRect, ERenderTargetLoadAction::ENoAction);
-		AccumulateParameters->RenderTargets[1] = TemporalReactiveRT.GetRenderTargetBinding();
-		AccumulateParameters->RenderTargets[2] = LockStatusRT.GetRenderTargetBinding();
+		if (History.TemporalReactive)
+		{
+			AccumulateParameters->RenderTargets[NextIndex++] = FScreenPassRenderTarget(History.TemporalReactive, OutputRect, ERenderTargetLoadAction::ENoAction).GetRenderTargetBinding();
+		}
+		AccumulateParameters->RenderTargets[NextIndex++] = FScreenPassRenderTarget(History.LockStatus, OutputRect, ERenderTargetLoadAction::ENoAction).GetRenderTargetBinding();
+	}
+
+	if (History.LumaHistory)
+	{
+		AccumulateParameters->RenderTargets[NextIndex++] = FScreenPassRenderTarget(History.LumaHistory, OutputRect, ERenderTargetLoadAction::ENoAction).GetRenderTargetBinding();
 	}
 
-	const bool bUseRCAS = (Sharpness > 0.0f);
-	if (!bUseRCAS)
+	if (!bUseRCAS && OutputTexture)
 	{
-		const size_t index = bIsUltraPerformance ? 2 : 3;
-		AccumulateParameters->RenderTargets[index] = UpscaledOutput.GetRenderTargetBinding();
+		AccumulateParameters->RenderTargets[NextIndex++] = FScreenPassRenderTarget(OutputTexture, OutputRect, ERenderTargetLoadAction::ENoAction).GetRenderTargetBinding();
 	}
 
 	// Assign common parameters to constant buffer.
 	AccumulateParameters->cbArmASR = ArmASRPassParameters;
+
+	return History;
 }
@@ -15,11 +15,27 @@
 #include <array>
 
 class FArmASR_UseWaveOps : SHADER_PERMUTATION_BOOL("FFXM_SPD_WAVE_OPERATIONS");
+class FArmASR_SpdSubgroupReduction : SHADER_PERMUTATION_SPARSE_INT("FFXM_SPD_SUBGROUP_REDUCTION", 0, 8, 16);
+
+// Returns the FArmASR_SpdSubgroupReduction to use, the number of lanes the subgroup reduction may rely on. It covers
+// 4x4 blocks of the group, in one shuffle step when every subgroup the device may launch has 16 lanes or more, or in
+// a shuffle and a groupshared step with 8. Narrower devices keep the quad operations only, as do all devices with
+// bAllowed false (r.ArmASR.SpdSubgroupReduction 0).
+// The shuffles take the lane of each thread to be its index in the 1D group modulo the subgroup size, which holds on
+// drivers that fill the subgroups of a group in thread order. r.ArmASR.SpdSubgroupReduction is the way out on others.
+inline int32 GetSpdSubgroupReductionWidth(const FStaticShaderPlatform Platform, bool bAllowed)
+{
+	if (!bAllowed || !ShouldUseWaveOps(Platform))
+	{
+		return 0;
+	}
+	return GRHIMinimumWaveSize >= 16 ? 16 : (GRHIMinimumWaveSize >= 8 ? 8 : 0);
+}
 
 class FArmASRComputeLuminancePyramidCS : public FGlobalShader
 {
 public:
-	using FPermutationDomain = TShaderPermutationDomain<FArmASR_UseWaveOps>;
+	using FPermutationDomain = TShaderPermutationDomain<FArmASR_UseWaveOps, FArmASR_SpdSubgroupReduction, FArmASR_PartialLumaPyramid, FArmASR_FusedLumaMip>;
 
 	DECLARE_GLOBAL_SHADER(FArmASRComputeLuminancePyramidCS);
 	SHADER_USE_PARAMETER_STRUCT(FArmASRComputeLuminancePyramidCS, FGlobalShader);
@@ -29,6 +45,7 @@ public:
 		SHADER_PARAMETER_STRUCT_REF(FArmASRComputeLuminanceParameters, cbArmASRSPD)
 		SHADER_PARAMETER_SAMPLER(SamplerState, s_LinearClamp)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_color_jittered)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_luma_mip_0)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_spd_global_atomic)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_img_mip_shading_change)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_img_mip_5)
@@ -43,11 +60,27 @@ public:
 		}
 
 		FPermutationDomain PermutationVector(Parameters.PermutationId);
+
+		if (!AreArmASRExperimentalPermutationsEnabled() && (PermutationVector.Get<FArmASR_PartialLumaPyramid>() || PermutationVector.Get<FArmASR_FusedLumaMip>()))
+		{
+			return false;
+		}
+
+		// Only the shading change mip is built from the fused first level.
+		if (PermutationVector.Get<FArmASR_FusedLumaMip>() && !PermutationVector.Get<FArmASR_PartialLumaPyramid>())
+		{
+			return false;
+		}
+
 		bool bPemutationUseWaveOps = PermutationVector.Get<FArmASR_UseWaveOps>();
+		if (PermutationVector.Get<FArmASR_SpdSubgroupReduction>() != 0 && !bPemutationUseWaveOps)
+		{
+			return false;
+		}
 
 		ERHIFeatureSupport WaveOpsSupport =
 			FDataDrivenShaderPlatformInfo::GetSupportsWaveOperations(Parameters.Platform);
-		if (bPemutationUseWaveOps && WaveOpsSupport == ERHIFeatureSupport::Unsupported)
+		if (bPemutationUseWaveOps && !CanCompileWaveOps(Parameters.Platform))
 		{
 			// Don't compile a permutation that uses wave ops if this platform can never support them
 			return false;
@@ -78,12 +111,17 @@ public:
 };
 
 // Function to setup Compute Luminance Shader parameters. ClpShaderParameters and ClpParameters will be updated.
+// The engine's scene colour downsample and eye adaptation chains are only built after the temporal upscaler, from its
+// output, so the only engine data available here is the previous frame's exposure (see SetCopyExposureParameters).
+// The shading change mip is therefore always built from the render resolution scene colour.
 inline void SetComputeLuminancePyramidParameters(
 	FArmASRComputeLuminancePyramidCS::FParameters* ClpShaderParameters,
 	FArmASRComputeLuminanceParameters* ClpParameters,
 	TUniformBufferRef<FArmASRPassParameters> ArmASRPassParameters,
 	const FRDGTextureSRVRef SceneColorTexture,
 	const FIntPoint InputExtents,
+	const bool bPartialLumaPyramid,                 // Exposure comes from the engine: only build the shading change mip
+	const FRDGTextureRef LumaMip0Texture,           // Generated UAV from DC shader, null unless the first level is fused into it
 	FRDGBuilder& GraphBuilder,
 	FIntVector& workGroups,
 	FArmASRInfo& ArmASRInfo)
@@ -92,11 +130,22 @@ inline void SetComputeLuminancePyramidParameters(
 	ClpShaderParameters->s_LinearClamp = TStaticSamplerState<SF_Bilinear>::GetRHI();
 
 	// SRV's
-	ClpShaderParameters->r_input_color_jittered = SceneColorTexture;
+	if (LumaMip0Texture)
+	{
+		ClpShaderParameters->r_luma_mip_0 = GraphBuilder.CreateSRV(FRDGTextureSRVDesc::Create(LumaMip0Texture));
+	}
+	else
+	{
+		ClpShaderParameters->r_input_color_jittered = SceneColorTexture;
+	}
 
 	// UAV's
 	const FIntPoint Size = { 1, 1 };
-	if (ArmASRInfo.Atomic)
+	if (bPartialLumaPyramid)
+	{
+		// SPD stops before its last workgroup reduction, so the global atomic isn't needed.
+	}
+	else if (ArmASRInfo.Atomic)
 	{
 		FRDGTextureRef GlobalAtomicTexture = GraphBuilder.RegisterExternalTexture(ArmASRInfo.Atomic.GetValue().RenderTarget, TEXT("GlobalAtomicTexture"));
 		FRDGTextureUAVDesc GlobalAtomicUAVDesc(GlobalAtomicTexture);
@@ -133,31 +182,56 @@ inline void SetComputeLuminancePyramidParameters(
 
 	const uint32 MipCount = uint32(1 + floor(log2(FMath::Max(MipSize.X, MipSize.Y))));
 	const EPixelFormat MipShadingFormat = bIsOpenGL ? PF_R32_FLOAT : PF_R16F;
-	FRDGTextureDesc MipShadingChangeDesc = FRDGTextureDesc::Create2D(
-		MipSize, MipShadingFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV, MipCount, 1);
-	FRDGTextureRef MipShadingChangeTexture = GraphBuilder.CreateTexture(MipShadingChangeDesc, TEXT("MipShadingChangeTexture"));
-	FRDGTextureUAVDesc MipShadingChangeUAVDesc(MipShadingChangeTexture, FFXM_FSR2_SHADING_CHANGE_MIP_LEVEL);
-	ClpShaderParameters->rw_img_mip_shading_change = GraphBuilder.CreateUAV(MipShadingChangeUAVDesc);
-
-	FRDGTextureUAVDesc Mip5UAVDesc(MipShadingChangeTexture, FFXM_FSR2_SHADING_CHANGE_MIPMAP_5);
-	ClpShaderParameters->rw_img_mip_5 = GraphBuilder.CreateUAV(Mip5UAVDesc);
-
-	const EPixelFormat AutoExposureFormat = bIsOpenGL ? PF_FloatRGBA : PF_G32R32F;
-	FRDGTextureDesc AutoExposureDesc =
-		FRDGTextureDesc::Create2D(Size, AutoExposureFormat, FClearValueBinding::Black,
-								  TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable, 1, 1);
-	FRDGTextureRef AutoExposureTexture = GraphBuilder.CreateTexture(AutoExposureDesc, TEXT("AutoExposureTexture"));
-	FRDGTextureUAVDesc AutoExposureUAVDesc(AutoExposureTexture);
-	ClpShaderParameters->rw_auto_exposure = GraphBuilder.CreateUAV(AutoExposureUAVDesc);
+	if (bPartialLumaPyramid)
+	{
+		// Only the shading change mip is read by Accumulate, store it alone as mip 0.
+		const FIntPoint ShadingChangeMipSize = {
+			FMath::Max(MipSize.X >> FFXM_FSR2_SHADING_CHANGE_MIP_LEVEL, 1),
+			FMath::Max(MipSize.Y >> FFXM_FSR2_SHADING_CHANGE_MIP_LEVEL, 1) };
+		FRDGTextureDesc MipShadingChangeDesc = FRDGTextureDesc::Create2D(
+			ShadingChangeMipSize, MipShadingFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV, 1, 1);
+		FRDGTextureRef MipShadingChangeTexture = GraphBuilder.CreateTexture(MipShadingChangeDesc, TEXT("MipShadingChangeTexture"));
+		ClpShaderParameters->rw_img_mip_shading_change = GraphBuilder.CreateUAV(FRDGTextureUAVDesc(MipShadingChangeTexture, 0));
+	}
+	else
+	{
+		FRDGTextureDesc MipShadingChangeDesc = FRDGTextureDesc::Create2D(
+			MipSize, MipShadingFormat, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV, MipCount, 1);
+		FRDGTextureRef MipShadingChangeTexture = GraphBuilder.CreateTexture(MipShadingChangeDesc, TEXT("MipShadingChangeTexture"));
+		FRDGTextureUAVDesc MipShadingChangeUAVDesc(MipShadingChangeTexture, FFXM_FSR2_SHADING_CHANGE_MIP_LEVEL);
+		ClpShaderParameters->rw_img_mip_shading_change = GraphBuilder.CreateUAV(MipShadingChangeUAVDesc);
+
+		FRDGTextureUAVDesc Mip5UAVDesc(MipShadingChangeTexture, FFXM_FSR2_SHADING_CHANGE_MIPMAP_5);
+		ClpShaderParameters->rw_img_mip_5 = GraphBuilder.CreateUAV(Mip5UAVDesc);
+	}
+
+	if (!bPartialLumaPyramid)
+	{
+		const EPixelFormat AutoExposureFormat = bIsOpenGL ? PF_FloatRGBA : PF_G32R32F;
+		FRDGTextureDesc AutoExposureDesc =
+			FRDGTextureDesc::Create2D(Size, AutoExposureFormat, FClearValueBinding::Black,
+									  TexCreate_ShaderResource | TexCreate_UAV, 1, 1);
+		FRDGTextureRef AutoExposureTexture = GraphBuilder.CreateTexture(AutoExposureDesc, TEXT("AutoExposureTexture"));
+		FRDGTextureUAVDesc AutoExposureUAVDesc(AutoExposureTexture);
+		ClpShaderParameters->rw_auto_exposure = GraphBuilder.CreateUAV(AutoExposureUAVDesc);
+	}
 
 	// Setup FArmASRComputeLuminanceParameters
-	std::array<uint32_t, 4> RectInfo = { 0, 0, InputExtents.X, InputExtents.Y };
+	// With the first level fused into Depth Clip, downsample from it instead of the input colour.
+	const FIntPoint SourceExtents = LumaMip0Texture ? LumaMip0Texture->Desc.Extent : InputExtents;
+	std::array<uint32_t, 4> RectInfo = { 0, 0, static_cast<uint32_t>(SourceExtents.X), static_cast<uint32_t>(SourceExtents.Y) };
 	SpdConfig spdConfig = SpdConfig();
 	spdConfig.Setup(RectInfo, -1);
 
 	// Assign values from SpdSetup
 	ClpParameters->numWorkGroups = spdConfig.NumWorkGroupsAndMips[0];
 	ClpParameters->mips = spdConfig.NumWorkGroupsAndMips[1];
+	if (bPartialLumaPyramid)
+	{
+		// Stop at the shading change mip, before SPD's last workgroup reduction.
+		const uint32 FirstMip = LumaMip0Texture ? 1 : 0;
+		ClpParameters->mips = FMath::Min<uint32>(ClpParameters->mips, FFXM_FSR2_SHADING_CHANGE_MIP_LEVEL + 1 - FirstMip);
+	}
 	ClpParameters->workGroupOffset = { spdConfig.WorkGroupOffset[0], spdConfig.WorkGroupOffset[1] };
 	ClpParameters->renderSize = { static_cast<uint32_t>(InputExtents.X), static_cast<uint32_t>(InputExtents.Y) };
 
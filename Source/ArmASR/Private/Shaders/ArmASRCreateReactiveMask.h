@@ -116,8 +116,7 @@ inline bool IsUsingLumenReflections(const FViewInfo& View)
 inline void SetReactiveMaskParameters(FRDGBuilder& GraphBuilder, FArmASRCreateReactiveMaskPS::FParameters* PassParameters, FArmASRInfo& ArmASRInfo,
 	const FIntPoint& InputExtents,
 	const FIntRect& InputRect,
-	const FRDGTextureRef ReactiveMaskTexture,
-	const FRDGTextureRef CompositeMaskTexture,
+	const FRDGTextureRef ReactiveAndCompositeMaskTexture,
 	const FRDGTextureRef SceneDepth,
 	const FRDGTextureRef SceneColor,
 	const FRDGTextureRef VelocityTexture,
@@ -127,11 +126,8 @@ inline void SetReactiveMaskParameters(FRDGBuilder& GraphBuilder, FArmASRCreateRe
 	FViewInfo& ViewInfo = (FViewInfo&)(View);
 	PassParameters->Sampler = TStaticSamplerState<SF_Point>::GetRHI();
 
-	const FScreenPassRenderTarget ReactiveMaskRT(ReactiveMaskTexture, InputRect, ERenderTargetLoadAction::ENoAction);
-	PassParameters->RenderTargets[0] = ReactiveMaskRT.GetRenderTargetBinding();
-
-	const FScreenPassRenderTarget CompositeMaskRT(CompositeMaskTexture, InputRect, ERenderTargetLoadAction::ENoAction);
-	PassParameters->RenderTargets[1] = CompositeMaskRT.GetRenderTargetBinding();
+	const FScreenPassRenderTarget ReactiveAndCompositeMaskRT(ReactiveAndCompositeMaskTexture, InputRect, ERenderTargetLoadAction::ENoAction);
+	PassParameters->RenderTargets[0] = ReactiveAndCompositeMaskRT.GetRenderTargetBinding();
 	if (ArmASRInfo.PostInputs.SceneTextures)
 	{
 		FRDGTextureRef GBufferB = (*ArmASRInfo.PostInputs.SceneTextures)->GBufferBTexture;
@@ -193,8 +189,6 @@ inline void SetReactiveMaskParameters(FRDGBuilder& GraphBuilder, FArmASRCreateRe
 		FRDGTextureSRVDesc GBufferBDesc = FRDGTextureSRVDesc::Create(GBufferB);
 		FRDGTextureSRVDesc GBufferDDesc = FRDGTextureSRVDesc::Create(GBufferD);
 		FRDGTextureSRVDesc ReflectionsDesc = FRDGTextureSRVDesc::Create(Reflections);
-		FRDGTextureUAVDesc ReactiveDesc(ReactiveMaskTexture);
-		FRDGTextureUAVDesc CompositeDesc(CompositeMaskTexture);
 
 		PassParameters->GBufferB = GraphBuilder.CreateSRV(GBufferBDesc);
 		PassParameters->GBufferD = GraphBuilder.CreateSRV(GBufferDDesc);
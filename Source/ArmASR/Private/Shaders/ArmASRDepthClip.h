@@ -4,6 +4,7 @@
 //
 
 #include "ArmASRShaderParameters.h"
+#include "ArmASRShaderUtils.h"
 
 #include "RenderGraphFwd.h"
 #include "ShaderCompilerCore.h"
@@ -13,7 +14,7 @@
 class FArmASRDepthClipPS : public FGlobalShader
 {
 public:
-	using FPermutationDomain = TShaderPermutationDomain<FArmASR_ApplyBalancedOpt, FArmASR_ApplyPerfOpt, FArmASR_ApplyUltraPerfOpt>;
+	using FPermutationDomain = TShaderPermutationDomain<FArmASR_ApplyBalancedOpt, FArmASR_ApplyPerfOpt, FArmASR_ApplyUltraPerfOpt, FArmASR_RecomputePreparedInputs, FArmASR_FusedLumaMip, FArmASR_EpochTaggedPrevDepth, FArmASR_HalfResPrevDepth, FArmASR_QuadShuffleNeighborhood>;
 
 	DECLARE_GLOBAL_SHADER(FArmASRDepthClipPS);
 	SHADER_USE_PARAMETER_STRUCT(FArmASRDepthClipPS, FGlobalShader);
@@ -25,8 +26,7 @@ public:
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_reconstructed_previous_nearest_depth)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_dilated_motion_vectors)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_dilatedDepth)
-		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_reactive_mask)
-		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_transparency_and_composition_mask)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_reactive_and_composition_masks)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_previous_dilated_motion_vectors)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_motion_vectors)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_color_jittered)
@@ -34,11 +34,52 @@ public:
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_exposure)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_dilated_depth_motion_vectors_input_luma)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_prev_dilated_depth_motion_vectors_input_luma)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_luma_mip_0)
 		RENDER_TARGET_BINDING_SLOTS()
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		if (!IsArmASRPresetPermutation(PermutationVector))
+		{
+			return false;
+		}
+
+		if (!AreArmASRExperimentalPermutationsEnabled() && (PermutationVector.Get<FArmASR_RecomputePreparedInputs>() || PermutationVector.Get<FArmASR_FusedLumaMip>() || PermutationVector.Get<FArmASR_EpochTaggedPrevDepth>() || PermutationVector.Get<FArmASR_HalfResPrevDepth>()))
+		{
+			return false;
+		}
+
+		if (PermutationVector.Get<FArmASR_RecomputePreparedInputs>() && PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>())
+		{
+			return false;
+		}
+
+		// Ultra Performance has no luminance pyramid. The first level is written through a pixel shader UAV, from fine
+		// derivatives.
+		if (PermutationVector.Get<FArmASR_FusedLumaMip>() && (PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>() || IsOpenGLPlatform(Parameters.Platform)))
+		{
+			return false;
+		}
+
+		// The half resolution previous depth is only used by the cheaper presets.
+		if (PermutationVector.Get<FArmASR_HalfResPrevDepth>() && !PermutationVector.Get<FArmASR_ApplyPerfOpt>() && !PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>())
+		{
+			return false;
+		}
+
+		// The quad shuffle is selected by ShouldUseWaveOps, like FArmASR_UseWaveOps.
+		const ERHIFeatureSupport WaveOpsSupport = FDataDrivenShaderPlatformInfo::GetSupportsWaveOperations(Parameters.Platform);
+		if (PermutationVector.Get<FArmASR_QuadShuffleNeighborhood>() && !CanCompileWaveOps(Parameters.Platform))
+		{
+			return false;
+		}
+		else if (!PermutationVector.Get<FArmASR_QuadShuffleNeighborhood>() && WaveOpsSupport == ERHIFeatureSupport::RuntimeGuaranteed)
+		{
+			return false;
+		}
+
 		return FArmASRGlobalShader::ShouldCompilePermutation(Parameters);
 	}
 
@@ -46,6 +87,12 @@ public:
 	{
 		// Define common shader flags.
 		FArmASRGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		if (PermutationVector.Get<FArmASR_QuadShuffleNeighborhood>())
+		{
+			OutEnvironment.CompilerFlags.Add(CFLAG_WaveOperations);
+		}
 	}
 };
 
@@ -62,11 +109,13 @@ inline void SetDepthClipParameters(
 	const FRDGTextureRef DilatedDepthMotionVectorsInputLumaTexture,
 	const FRDGTextureRef PrevDilatedDepthMotionVectorsInputLumaTexture,
 	const FRDGTextureRef MotionVectorTexture,
-	const FRDGTextureRef ReactiveMaskTexture,
-	const FRDGTextureRef CompositeMaskTexture,
+	const FRDGTextureRef ReactiveAndCompositeMaskTexture,
 	const FRDGTextureSRVRef DepthTexture,
 	const FRDGTextureSRVRef SceneColorTexture,
 	const EShaderQualityPreset qualityPreset,
+	const bool bRecomputePreparedInputs,                // Not for Ultra Performance: only output the depth clip, not the prepared input colour
+	const bool bFusedLumaMip,                           // Not for Ultra Performance: also output the first level of the luminance pyramid
+	const bool bComputeDepthClip,                       // Outputs are also written through UAVs by FArmASRDepthClipCS
 	const FIntPoint& InputExtents,
 	const FScreenPassTextureViewport& Viewport,
 	FRDGBuilder& GraphBuilder)
@@ -107,13 +156,9 @@ inline void SetDepthClipParameters(
 		DcShaderParameters->r_previous_dilated_motion_vectors = PrevDilatedMotionVectorsSRVTexture;
 	}
 
-	FRDGTextureSRVDesc ReactiveMaskSRVDesc = FRDGTextureSRVDesc::Create(ReactiveMaskTexture);
-	FRDGTextureSRVRef ReactiveMaskSRVTexture = GraphBuilder.CreateSRV(ReactiveMaskSRVDesc);
-	DcShaderParameters->r_reactive_mask = ReactiveMaskSRVTexture;
-
-	FRDGTextureSRVDesc CompositeMaskSRVDesc = FRDGTextureSRVDesc::Create(CompositeMaskTexture);
-	FRDGTextureSRVRef CompositeMaskSRVTexture = GraphBuilder.CreateSRV(CompositeMaskSRVDesc);
-	DcShaderParameters->r_transparency_and_composition_mask = CompositeMaskSRVTexture;
+	FRDGTextureSRVDesc ReactiveAndCompositeMaskSRVDesc = FRDGTextureSRVDesc::Create(ReactiveAndCompositeMaskTexture);
+	FRDGTextureSRVRef ReactiveAndCompositeMaskSRVTexture = GraphBuilder.CreateSRV(ReactiveAndCompositeMaskSRVDesc);
+	DcShaderParameters->r_reactive_and_composition_masks = ReactiveAndCompositeMaskSRVTexture;
 
 	FRDGTextureSRVDesc MotionVectorSRVDesc = FRDGTextureSRVDesc::Create(MotionVectorTexture);
 	FRDGTextureSRVRef MotionVectorSRVTexture = GraphBuilder.CreateSRV(MotionVectorSRVDesc);
@@ -123,21 +168,146 @@ inline void SetDepthClipParameters(
 	DcShaderParameters->r_input_color_jittered = SceneColorTexture;
 	DcShaderParameters->r_input_exposure = AutoExposureTexture;
 
-	// Create textures for all RenderTargets
-	FRDGTextureDesc DilatedReactiveMaskDesc = FRDGTextureDesc::Create2D(InputExtents, PF_R8G8, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
+	// Create textures for all RenderTargets. The compute variant only writes them through UAVs, the bindings then just
+	// carry the textures to SetDepthClipCSParameters and the later passes.
+	const ETextureCreateFlags OutputFlags = TexCreate_ShaderResource | (bComputeDepthClip ? TexCreate_UAV : TexCreate_RenderTargetable);
+	FRDGTextureDesc DilatedReactiveMaskDesc = FRDGTextureDesc::Create2D(InputExtents, PF_R8G8, FClearValueBinding::Black, OutputFlags, 1, 1);
 	FRDGTextureRef DilatedReactiveMaskTexture = GraphBuilder.CreateTexture(DilatedReactiveMaskDesc, TEXT("DilatedReactiveMaskTexture"));
 
 	// Create RenderTargets and assign to parameters.
 	const FScreenPassRenderTarget DilatedReactiveMaskRT(DilatedReactiveMaskTexture, Viewport.Rect, ERenderTargetLoadAction::ENoAction);
 	DcShaderParameters->RenderTargets[0] = DilatedReactiveMaskRT.GetRenderTargetBinding();
 
-	if (!bIsUltraPerformance)
+	if (!bIsUltraPerformance && bRecomputePreparedInputs)
+	{
+		// Accumulate recomputes the prepared input colour, so only the depth clip is kept.
+		FRDGTextureDesc DepthClipDesc = FRDGTextureDesc::Create2D(InputExtents, PF_R8, FClearValueBinding::Black, OutputFlags, 1, 1);
+		FRDGTextureRef DepthClipTexture = GraphBuilder.CreateTexture(DepthClipDesc, TEXT("DepthClipTexture"));
+		DcShaderParameters->RenderTargets[1] = FScreenPassRenderTarget(DepthClipTexture, Viewport.Rect, ERenderTargetLoadAction::ENoAction).GetRenderTargetBinding();
+	}
+	else if (!bIsUltraPerformance)
 	{
-		FRDGTextureDesc PreparedInputColorDesc = FRDGTextureDesc::Create2D(InputExtents, PF_FloatRGBA, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
+		FRDGTextureDesc PreparedInputColorDesc = FRDGTextureDesc::Create2D(InputExtents, PF_FloatRGBA, FClearValueBinding::Black, OutputFlags, 1, 1);
 		FRDGTextureRef PreparedInputColorTexture = GraphBuilder.CreateTexture(PreparedInputColorDesc, TEXT("PreparedInputColorTexture"));
 		const FScreenPassRenderTarget PreparedInputColorRT(PreparedInputColorTexture, Viewport.Rect, ERenderTargetLoadAction::ENoAction);
 		DcShaderParameters->RenderTargets[1] = PreparedInputColorRT.GetRenderTargetBinding();
 	}
+	if (bFusedLumaMip)
+	{
+		// Half resolution log luma, read back by Compute Luminance Pyramid instead of the input colour.
+		const FIntPoint LumaMip0Size = { FMath::Max(InputExtents.X / 2, 1), FMath::Max(InputExtents.Y / 2, 1) };
+		FRDGTextureDesc LumaMip0Desc = FRDGTextureDesc::Create2D(LumaMip0Size, PF_R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV, 1, 1);
+		FRDGTextureRef LumaMip0Texture = GraphBuilder.CreateTexture(LumaMip0Desc, TEXT("LumaMip0Texture"));
+		DcShaderParameters->rw_luma_mip_0 = GraphBuilder.CreateUAV(LumaMip0Texture);
+	}
+
 	// Assign common parameters to constant buffer.
 	DcShaderParameters->cbArmASR = ArmASRPassParameters;
 }
+
+// Compute variant of FArmASRDepthClipPS. Each thread group stages its tile of the 3x3 neighborhoods in groupshared
+// memory. Not for OpenGL or FArmASR_FusedLumaMip, which needs pixel quad derivatives.
+class FArmASRDepthClipCS : public FGlobalShader
+{
+public:
+	using FPermutationDomain = TShaderPermutationDomain<FArmASR_ApplyBalancedOpt, FArmASR_ApplyPerfOpt, FArmASR_ApplyUltraPerfOpt, FArmASR_RecomputePreparedInputs, FArmASR_EpochTaggedPrevDepth, FArmASR_HalfResPrevDepth, FArmASR_ComputeGroupSize>;
+
+	DECLARE_GLOBAL_SHADER(FArmASRDepthClipCS);
+	SHADER_USE_PARAMETER_STRUCT(FArmASRDepthClipCS, FGlobalShader);
+
+	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
+		SHADER_PARAMETER_STRUCT_REF(FArmASRPassParameters, cbArmASR)
+		SHADER_PARAMETER_SAMPLER(SamplerState, s_LinearClamp)
+		SHADER_PARAMETER_SAMPLER(SamplerState, s_PointClamp)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_reconstructed_previous_nearest_depth)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_dilated_motion_vectors)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_dilatedDepth)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_reactive_and_composition_masks)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_previous_dilated_motion_vectors)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_motion_vectors)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_color_jittered)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_depth)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_exposure)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_dilated_depth_motion_vectors_input_luma)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_prev_dilated_depth_motion_vectors_input_luma)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_dilated_reactive_masks)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_prepared_input_color)
+		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_depth_clip)
+	END_SHADER_PARAMETER_STRUCT()
+
+	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
+	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		// Only used by r.ArmASR.GroupsharedNeighborhood, which is experimental.
+		if (!AreArmASRExperimentalPermutationsEnabled() || IsOpenGLPlatform(Parameters.Platform) || !IsArmASRPresetPermutation(PermutationVector))
+		{
+			return false;
+		}
+		// The thread group sizes other than 8x8 are experimental too, as in Lock.
+		if (!AreArmASRExperimentalPermutationsEnabled() && PermutationVector.Get<FArmASR_ComputeGroupSize>() != 0)
+		{
+			return false;
+		}
+		if (PermutationVector.Get<FArmASR_RecomputePreparedInputs>() && PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>())
+		{
+			return false;
+		}
+		if (PermutationVector.Get<FArmASR_HalfResPrevDepth>() && !PermutationVector.Get<FArmASR_ApplyPerfOpt>() && !PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>())
+		{
+			return false;
+		}
+
+		return FArmASRGlobalShader::ShouldCompilePermutation(Parameters);
+	}
+
+	static void ModifyCompilationEnvironment(const FGlobalShaderPermutationParameters& Parameters, FShaderCompilerEnvironment& OutEnvironment)
+	{
+		// Define common shader flags.
+		FArmASRGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+		OutEnvironment.SetDefine(TEXT("FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD"), 1);
+
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		SetArmASRComputeGroupSizeDefines(PermutationVector.Get<FArmASR_ComputeGroupSize>(), OutEnvironment);
+	}
+};
+
+// Function to setup the compute Depth Clip shader parameters from the pixel shader ones. DcShaderParameters must have
+// been set up by SetDepthClipParameters with bComputeDepthClip, its render targets are then written through UAVs.
+inline void SetDepthClipCSParameters(
+	FArmASRDepthClipCS::FParameters* DcCSShaderParameters,
+	const FArmASRDepthClipPS::FParameters* DcShaderParameters,
+	const bool bRecomputePreparedInputs,                // Must match the value given to SetDepthClipParameters
+	FRDGBuilder& GraphBuilder)
+{
+	DcCSShaderParameters->cbArmASR = DcShaderParameters->cbArmASR;
+	DcCSShaderParameters->s_LinearClamp = DcShaderParameters->s_LinearClamp;
+	DcCSShaderParameters->s_PointClamp = DcShaderParameters->s_PointClamp;
+
+	// SRV's
+	DcCSShaderParameters->r_reconstructed_previous_nearest_depth = DcShaderParameters->r_reconstructed_previous_nearest_depth;
+	DcCSShaderParameters->r_dilated_motion_vectors = DcShaderParameters->r_dilated_motion_vectors;
+	DcCSShaderParameters->r_dilatedDepth = DcShaderParameters->r_dilatedDepth;
+	DcCSShaderParameters->r_reactive_and_composition_masks = DcShaderParameters->r_reactive_and_composition_masks;
+	DcCSShaderParameters->r_previous_dilated_motion_vectors = DcShaderParameters->r_previous_dilated_motion_vectors;
+	DcCSShaderParameters->r_input_motion_vectors = DcShaderParameters->r_input_motion_vectors;
+	DcCSShaderParameters->r_input_color_jittered = DcShaderParameters->r_input_color_jittered;
+	DcCSShaderParameters->r_input_depth = DcShaderParameters->r_input_depth;
+	DcCSShaderParameters->r_input_exposure = DcShaderParameters->r_input_exposure;
+	DcCSShaderParameters->r_dilated_depth_motion_vectors_input_luma = DcShaderParameters->r_dilated_depth_motion_vectors_input_luma;
+	DcCSShaderParameters->r_prev_dilated_depth_motion_vectors_input_luma = DcShaderParameters->r_prev_dilated_depth_motion_vectors_input_luma;
+
+	// UAV's
+	DcCSShaderParameters->rw_dilated_reactive_masks = GraphBuilder.CreateUAV(DcShaderParameters->RenderTargets[0].GetTexture());
+	if (FRDGTextureRef SecondOutput = DcShaderParameters->RenderTargets[1].GetTexture())
+	{
+		// Only the depth clip factor is kept when the prepared input colour is recomputed.
+		if (bRecomputePreparedInputs)
+		{
+			DcCSShaderParameters->rw_depth_clip = GraphBuilder.CreateUAV(SecondOutput);
+		}
+		else
+		{
+			DcCSShaderParameters->rw_prepared_input_color = GraphBuilder.CreateUAV(SecondOutput);
+		}
+	}
+}
@@ -8,7 +8,7 @@
 class FArmASRLockCS : public FGlobalShader
 {
 public:
-	using FPermutationDomain = TShaderPermutationDomain<FArmASR_ApplyUltraPerfOpt>;
+	using FPermutationDomain = TShaderPermutationDomain<FArmASR_ApplyUltraPerfOpt, FArmASR_RecomputePreparedInputs, FArmASR_GroupsharedNeighborhood, FArmASR_ComputeGroupSize>;
 
 	DECLARE_GLOBAL_SHADER(FArmASRLockCS);
 	SHADER_USE_PARAMETER_STRUCT(FArmASRLockCS, FGlobalShader);
@@ -19,11 +19,32 @@ public:
 		SHADER_PARAMETER_SAMPLER(SamplerState, s_PointClamp)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_lock_input_luma)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_dilated_depth_motion_vectors_input_luma)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_color_jittered)
+		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_exposure)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_new_locks)
 	END_SHADER_PARAMETER_STRUCT()
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+
+		// Ultra Performance already reads the input colour directly.
+		if (PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>() && PermutationVector.Get<FArmASR_RecomputePreparedInputs>())
+		{
+			return false;
+		}
+
+		if (!AreArmASRExperimentalPermutationsEnabled() && (PermutationVector.Get<FArmASR_RecomputePreparedInputs>() || PermutationVector.Get<FArmASR_GroupsharedNeighborhood>() || PermutationVector.Get<FArmASR_ComputeGroupSize>() != 0))
+		{
+			return false;
+		}
+
+		// The thread group size is only chosen for the groupshared variant, the other one always runs 8x8 groups.
+		if (!PermutationVector.Get<FArmASR_GroupsharedNeighborhood>() && PermutationVector.Get<FArmASR_ComputeGroupSize>() != 0)
+		{
+			return false;
+		}
+
 		return FArmASRGlobalShader::ShouldCompilePermutation(Parameters);
 	}
 
@@ -31,16 +52,22 @@ public:
 	{
 		// Define common shader flags.
 		FArmASRGlobalShader::ModifyCompilationEnvironment(Parameters, OutEnvironment);
+
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+		SetArmASRComputeGroupSizeDefines(PermutationVector.Get<FArmASR_ComputeGroupSize>(), OutEnvironment);
 	}
 };
 
 // Function to setup Lock shader parameters
 inline void SetLockParameters(
 	bool bIsUltraPerformance,
+	bool bRecomputePreparedInputs,
 	FArmASRLockCS::FParameters* LShaderParameters,
 	TUniformBufferRef<FArmASRPassParameters> ArmASRPassParameters,
 	const FRDGTextureRef LockLumaTexture,           // Generated RT from RPD shader
 	const FRDGTextureRef DilatedDepthMotionVectorsInputLumaTexture,
+	const FRDGTextureSRVRef SceneColorTexture,
+	const FRDGTextureSRVRef AutoExposureTexture,    // Generated from CLP shader or Unreal Engine
 	FRDGTextureRef OutLockMaskTexture,
 	const FIntPoint& OutputExtents,
 	FRDGBuilder& GraphBuilder)
@@ -57,6 +84,12 @@ inline void SetLockParameters(
 			GraphBuilder.CreateSRV(DilatedDepthMotionVectorsInputLumaSRVDesc);
 		LShaderParameters->r_dilated_depth_motion_vectors_input_luma = DilatedDepthMotionVectorsInputLumaSRVTexture;
 	}
+	else if (bRecomputePreparedInputs)
+	{
+		// The luma is recomputed from the input colour instead of read from Reconstruct Previous Depth.
+		LShaderParameters->r_input_color_jittered = SceneColorTexture;
+		LShaderParameters->r_input_exposure = AutoExposureTexture;
+	}
 	else
 	{
 		FRDGTextureSRVDesc LockLumaSRVDesc = FRDGTextureSRVDesc::Create(LockLumaTexture);
@@ -11,15 +11,20 @@
 #include "ShaderParameterStruct.h"
 #include "SystemTextures.h"
 
+class FArmASR_RcasUpsample : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_RCAS_UPSAMPLE");
+
 class FArmASRRCASPS : public FGlobalShader
 {
 public:
+	using FPermutationDomain = TShaderPermutationDomain<FArmASR_RcasUpsample>;
+
 	DECLARE_GLOBAL_SHADER(FArmASRRCASPS);
 	SHADER_USE_PARAMETER_STRUCT(FArmASRRCASPS, FGlobalShader);
 
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 		SHADER_PARAMETER_STRUCT_REF(FArmASRPassParameters, cbArmASR)
 		SHADER_PARAMETER_STRUCT_REF(FArmASRRCASParameters, cbArmASRRCAS)
+		SHADER_PARAMETER_SAMPLER(SamplerState, s_LinearClamp)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_exposure)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_rcas_input)
 		SHADER_PARAMETER_RDG_TEXTURE_UAV(RWTexture2D, rw_upscaled_output)
@@ -47,6 +52,7 @@ inline void SetRCASParameters(
 	const FRDGTextureRef InputTexture,
 	const FRDGTextureRef OutputTexture,
 	const float Sharpness,
+	const bool bUpsample,                   // InputTexture is the reduced-resolution history
 	const FIntRect& OutputRect,
 	FRDGBuilder& GraphBuilder)
 {
@@ -61,6 +67,12 @@ inline void SetRCASParameters(
 	RcasConfig[3] = 0;
 
 	RCASConstantParameters->rcasConfig = FUintVector4(RcasConfig[0], RcasConfig[1], RcasConfig[2], RcasConfig[3]);
+	RCASConstantParameters->rcasUpsampleConfig = FVector4f(
+		bUpsample ? 1.0f / OutputTexture->Desc.Extent.X : 0.0f,
+		bUpsample ? 1.0f / OutputTexture->Desc.Extent.Y : 0.0f,
+		(Sharpness > 0.0f) ? 1.0f : 0.0f,
+		0.0f);
+	RCASParameters->s_LinearClamp = TStaticSamplerState<SF_Bilinear>::GetRHI();
 	RCASParameters->cbArmASR = ArmASRPassParameters;
 	RCASParameters->cbArmASRRCAS = TUniformBufferRef<FArmASRRCASParameters>::CreateUniformBufferImmediate(*RCASConstantParameters, UniformBuffer_SingleDraw);
 
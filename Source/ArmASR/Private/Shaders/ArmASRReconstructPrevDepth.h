@@ -12,13 +12,14 @@
 class FArmASRReconstructPrevDepthPS : public FGlobalShader
 {
 public:
-	using FPermutationDomain = TShaderPermutationDomain<FArmASR_ApplyUltraPerfOpt>;
+	using FPermutationDomain = TShaderPermutationDomain<FArmASR_ApplyUltraPerfOpt, FArmASR_RecomputePreparedInputs, FArmASR_GatherNearestDepth, FArmASR_EpochTaggedPrevDepth, FArmASR_HalfResPrevDepth>;
 
 	DECLARE_GLOBAL_SHADER(FArmASRReconstructPrevDepthPS);
 	SHADER_USE_PARAMETER_STRUCT(FArmASRReconstructPrevDepthPS, FGlobalShader);
 
 	BEGIN_SHADER_PARAMETER_STRUCT(FParameters, )
 		SHADER_PARAMETER_STRUCT_REF(FArmASRPassParameters, cbArmASR)
+		SHADER_PARAMETER_SAMPLER(SamplerState, s_PointClamp)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_motion_vectors)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_depth)
 		SHADER_PARAMETER_RDG_TEXTURE_SRV(Texture2D, r_input_color_jittered)
@@ -29,6 +30,19 @@ public:
 
 	static bool ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 	{
+		const FPermutationDomain PermutationVector(Parameters.PermutationId);
+
+		// Ultra Performance already stores the luma in the packed depth/velocity target.
+		if (PermutationVector.Get<FArmASR_ApplyUltraPerfOpt>() && PermutationVector.Get<FArmASR_RecomputePreparedInputs>())
+		{
+			return false;
+		}
+
+		if (!AreArmASRExperimentalPermutationsEnabled() && (PermutationVector.Get<FArmASR_RecomputePreparedInputs>() || PermutationVector.Get<FArmASR_GatherNearestDepth>() || PermutationVector.Get<FArmASR_EpochTaggedPrevDepth>() || PermutationVector.Get<FArmASR_HalfResPrevDepth>()))
+		{
+			return false;
+		}
+
 		return FArmASRGlobalShader::ShouldCompilePermutation(Parameters);
 	}
 
@@ -42,12 +56,15 @@ public:
 // Function to setup Reconstruct Previous Depth Shader parameters. RpdShaderParameters will be updated.
 inline void SetReconstructPrevDepthParameters(
 	bool bIsUltraPerformance,
+	bool bRecomputePreparedInputs,
+	bool bHalfResPrevDepth,
 	FArmASRReconstructPrevDepthPS::FParameters* RpdShaderParameters,
 	TUniformBufferRef<FArmASRPassParameters> ArmASRPassParameters,
 	const FRDGTextureRef MotionVectorTexture,
 	const FRDGTextureSRVRef DepthTexture,
 	const FRDGTextureSRVRef SceneColorTexture,
 	const FRDGTextureSRVRef AutoExposureTexture, // Generated from CLP shader or Unreal Engine
+	const FRDGTextureRef EpochTaggedNearestDepthTexture, // From history when its epochs haven't run out, otherwise nullptr
 	const FIntPoint& InputExtents,
 	const FScreenPassTextureViewport& Viewport,
 	FRDGBuilder& GraphBuilder)
@@ -62,12 +79,25 @@ inline void SetReconstructPrevDepthParameters(
 	// As auto exposure is enabled, use for r_input_exposure
 	RpdShaderParameters->r_input_exposure = AutoExposureTexture;
 
+	// Only read by the gathered nearest depth permutation.
+	RpdShaderParameters->s_PointClamp = TStaticSamplerState<SF_Point>::GetRHI();
+
 	// UAV's
-	FRDGTextureDesc NearestDepthDesc = FRDGTextureDesc::Create2D(InputExtents, PF_R32_UINT, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV | TexCreate_RenderTargetable, 1, 1);
-	FRDGTextureRef NearestDepthTexture = GraphBuilder.CreateTexture(NearestDepthDesc, TEXT("ReconstructedPreviousNearestDepthTexture"));
-	RpdShaderParameters->rw_reconstructed_previous_nearest_depth = GraphBuilder.CreateUAV(NearestDepthTexture);
-	// Clear the reconstructed previous nearest depth texture as the shader doesn't always write to all elements
-	AddClearRenderTargetPass(GraphBuilder, NearestDepthTexture);
+	if (EpochTaggedNearestDepthTexture)
+	{
+		// Texels from earlier frames carry an older epoch and read as cleared, so no clear is needed.
+		RpdShaderParameters->rw_reconstructed_previous_nearest_depth = GraphBuilder.CreateUAV(EpochTaggedNearestDepthTexture);
+	}
+	else
+	{
+		const FIntPoint NearestDepthExtents = bHalfResPrevDepth ? FIntPoint::DivideAndRoundUp(InputExtents, 2) : InputExtents;
+		FRDGTextureDesc NearestDepthDesc = FRDGTextureDesc::Create2D(NearestDepthExtents, PF_R32_UINT, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_UAV, 1, 1);
+		FRDGTextureRef NearestDepthTexture = GraphBuilder.CreateTexture(NearestDepthDesc, TEXT("ReconstructedPreviousNearestDepthTexture"));
+		RpdShaderParameters->rw_reconstructed_previous_nearest_depth = GraphBuilder.CreateUAV(NearestDepthTexture);
+		// Clear the reconstructed previous nearest depth texture as the shader doesn't always write to all elements.
+		// The texture is only accessed through atomics, so clear it as a UAV rather than making it render targetable.
+		AddClearUAVPass(GraphBuilder, RpdShaderParameters->rw_reconstructed_previous_nearest_depth, 0u);
+	}
 
 	if (bIsUltraPerformance)
 	{
@@ -86,9 +116,6 @@ inline void SetReconstructPrevDepthParameters(
 		FRDGTextureDesc DilatedVelocityDesc = FRDGTextureDesc::Create2D(InputExtents, PF_G16R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
 		FRDGTextureRef DilatedVelocityTexture = GraphBuilder.CreateTexture(DilatedVelocityDesc, TEXT("DilatedVelocityTexture"));
 
-		FRDGTextureDesc LockLumaDesc = FRDGTextureDesc::Create2D(InputExtents, PF_R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
-		FRDGTextureRef LockLumaTexture = GraphBuilder.CreateTexture(LockLumaDesc, TEXT("LockLumaTexture"));
-
 		// Create RenderTargets and assign to parameters.
 		const FScreenPassRenderTarget DilatedDepthRT(DilatedDepthTexture, Viewport.Rect, ERenderTargetLoadAction::ENoAction);
 		RpdShaderParameters->RenderTargets[0] = DilatedDepthRT.GetRenderTargetBinding();
@@ -96,8 +123,15 @@ inline void SetReconstructPrevDepthParameters(
 		const FScreenPassRenderTarget DilatedVelocityRT(DilatedVelocityTexture, Viewport.Rect, ERenderTargetLoadAction::ENoAction);
 		RpdShaderParameters->RenderTargets[1] = DilatedVelocityRT.GetRenderTargetBinding();
 
-		const FScreenPassRenderTarget LockLumaRT(LockLumaTexture, Viewport.Rect, ERenderTargetLoadAction::ENoAction);
-		RpdShaderParameters->RenderTargets[2] = LockLumaRT.GetRenderTargetBinding();
+		// The Lock pass recomputes the luma from the input colour instead.
+		if (!bRecomputePreparedInputs)
+		{
+			FRDGTextureDesc LockLumaDesc = FRDGTextureDesc::Create2D(InputExtents, PF_R16F, FClearValueBinding::Black, TexCreate_ShaderResource | TexCreate_RenderTargetable, 1, 1);
+			FRDGTextureRef LockLumaTexture = GraphBuilder.CreateTexture(LockLumaDesc, TEXT("LockLumaTexture"));
+
+			const FScreenPassRenderTarget LockLumaRT(LockLumaTexture, Viewport.Rect, ERenderTargetLoadAction::ENoAction);
+			RpdShaderParameters->RenderTargets[2] = LockLumaRT.GetRenderTargetBinding();
+		}
 	}
 
 	// Assign common parameters to constant buffer.
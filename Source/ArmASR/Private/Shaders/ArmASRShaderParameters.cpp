@@ -6,6 +6,7 @@
 #include "ArmASRShaderParameters.h"
 
 #include "DataDrivenShaderPlatformInfo.h"
+#include "HAL/IConsoleManager.h"
 #include "ShaderCompilerCore.h"
 
 // To generate shaders this is required in .cpp file.
@@ -13,6 +14,12 @@ IMPLEMENT_UNIFORM_BUFFER_STRUCT(FArmASRPassParameters, "cbArmASR");
 IMPLEMENT_UNIFORM_BUFFER_STRUCT(FArmASRComputeLuminanceParameters, "cbArmASRSPD");
 IMPLEMENT_UNIFORM_BUFFER_STRUCT(FArmASRRCASParameters, "cbArmASRRCAS");
 
+bool AreArmASRExperimentalPermutationsEnabled()
+{
+	static const TConsoleVariableData<int32>* CVarExperimentalPermutations = IConsoleManager::Get().FindTConsoleVariableDataInt(TEXT("r.ArmASR.ExperimentalShaderPermutations"));
+	return CVarExperimentalPermutations && CVarExperimentalPermutations->GetValueOnAnyThread() != 0;
+}
+
 bool FArmASRGlobalShader::ShouldCompilePermutation(const FGlobalShaderPermutationParameters& Parameters)
 {
 	return IsFeatureLevelSupported(Parameters.Platform, ERHIFeatureLevel::ES3_1);
@@ -28,6 +28,54 @@
 class FArmASR_ApplyBalancedOpt : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_SHADER_OPT_BALANCED");
 class FArmASR_ApplyPerfOpt : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_SHADER_OPT_PERFORMANCE");
 class FArmASR_ApplyUltraPerfOpt : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_SHADER_OPT_ULTRA_PERFORMANCE");
+class FArmASR_RecomputePreparedInputs : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_RECOMPUTE_PREPARED_INPUTS");
+class FArmASR_PartialLumaPyramid : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_PARTIAL_LUMA_PYRAMID");
+class FArmASR_FusedLumaMip : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_FUSED_LUMA_MIP");
+class FArmASR_GatherNearestDepth : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_GATHER_NEAREST_DEPTH");
+class FArmASR_EpochTaggedPrevDepth : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_EPOCH_TAGGED_PREV_DEPTH");
+class FArmASR_HalfResPrevDepth : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_HALF_RES_PREV_DEPTH");
+class FArmASR_GroupsharedNeighborhood : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_GROUPSHARED_NEIGHBORHOOD");
+class FArmASR_QuadShuffleNeighborhood : SHADER_PERMUTATION_BOOL("FFXM_FSR2_OPTION_QUAD_SHUFFLE_NEIGHBORHOOD");
+class FArmASR_ComputeGroupSize : SHADER_PERMUTATION_INT("ARMASR_COMPUTE_GROUP_SIZE", 4);
+
+// Thread group sizes of the 2D compute passes, indexed by FArmASR_ComputeGroupSize. The first is the 8x8 of
+// FComputeShaderUtils::kGolden2DGroupSize, used until a size has been chosen for the device.
+inline FIntPoint GetArmASRComputeGroupSize(int32 Index)
+{
+	switch (Index)
+	{
+	case 1:
+		return FIntPoint(8, 4);
+	case 2:
+		return FIntPoint(16, 8);
+	case 3:
+		return FIntPoint(16, 16);
+	default:
+		return FIntPoint(8, 8);
+	}
+}
+
+inline void SetArmASRComputeGroupSizeDefines(int32 Index, FShaderCompilerEnvironment& OutEnvironment)
+{
+	const FIntPoint GroupSize = GetArmASRComputeGroupSize(Index);
+	OutEnvironment.SetDefine(TEXT("FFXM_FSR2_THREAD_GROUP_WIDTH"), GroupSize.X);
+	OutEnvironment.SetDefine(TEXT("FFXM_FSR2_THREAD_GROUP_HEIGHT"), GroupSize.Y);
+}
+
+// True when the project compiles the optional shader permutations selected by the experimental console variables,
+// see r.ArmASR.ExperimentalShaderPermutations. They are never selected at runtime otherwise.
+bool AreArmASRExperimentalPermutationsEnabled();
+
+// The preset permutation dimensions are only set together as the quality presets set them: none for Quality, Balanced
+// alone, Balanced and Perf for Performance, or UltraPerf alone.
+template<typename TPermutationDomain>
+bool IsArmASRPresetPermutation(const TPermutationDomain& PermutationVector)
+{
+	const bool bBalanced = PermutationVector.template Get<FArmASR_ApplyBalancedOpt>();
+	const bool bPerf = PermutationVector.template Get<FArmASR_ApplyPerfOpt>();
+	const bool bUltraPerf = PermutationVector.template Get<FArmASR_ApplyUltraPerfOpt>();
+	return (bBalanced || !bPerf) && !(bUltraPerf && bBalanced);
+}
 
 class FArmASRGlobalShader : public FGlobalShader
 {
@@ -57,6 +105,9 @@ BEGIN_UNIFORM_BUFFER_STRUCT(FArmASRPassParameters, )
 	SHADER_PARAMETER(float, fDeltaTime)
 	SHADER_PARAMETER(float, fDynamicResChangeFactor)
 	SHADER_PARAMETER(float, fViewSpaceToMetersFactor)
+	SHADER_PARAMETER(uint32, uReconstructedDepthEpoch)
+	SHADER_PARAMETER(uint32, uGroupSwizzleWidth)
+	SHADER_PARAMETER(uint32, uJitterPhaseIndex)
 END_UNIFORM_BUFFER_STRUCT()
 
 // Parameters for the compute luminance pyramid shader.
@@ -70,4 +121,5 @@ END_UNIFORM_BUFFER_STRUCT()
 // Parameters for the RCAS shader.
 BEGIN_UNIFORM_BUFFER_STRUCT(FArmASRRCASParameters, )
 	SHADER_PARAMETER(FUintVector4, rcasConfig)
+	SHADER_PARAMETER(FVector4f, rcasUpsampleConfig)
 END_UNIFORM_BUFFER_STRUCT()
@@ -24,6 +24,7 @@
 #pragma once
 
 #include "SceneRendering.h"
+#include "DataDrivenShaderPlatformInfo.h"
 
 #include <array>
 #include <cmath>
@@ -41,6 +42,9 @@
 const float ARM_ASR_EPSILON = 1e-06f;
 const float ARM_ASR_PI = 3.141592653589793f;
 
+// Number of texels in the Lanczos lookup texture. Must match FFXM_FSR2_LANCZOS_LUT_WIDTH.
+static const int32_t ARM_ASR_LANCZOS_LUT_WIDTH = 128;
+
 static const int32_t ARM_ASR_MAX_BIAS_TEXTURE_WIDTH = 16;
 static const int32_t ARM_ASR_MAX_BIAS_TEXTURE_HEIGHT = 16;
 static const int32_t ARM_ASR_MAX_BIAS_TEXTURE_SIZE = ARM_ASR_MAX_BIAS_TEXTURE_WIDTH * ARM_ASR_MAX_BIAS_TEXTURE_HEIGHT;
@@ -111,6 +115,20 @@ inline int32_t GetJitterPhaseCount(int32_t RenderWidth, int32_t DisplayWidth)
 	return JitterPhaseCount;
 }
 
+// Android Vulkan reports no wave support in its data driven shader platform info, although most devices expose the subgroup
+// operations the wave permutations need. They are compiled for it anyway and selected from the RHI's probe of the device.
+inline bool CanCompileWaveOps(const FStaticShaderPlatform Platform)
+{
+	return FDataDrivenShaderPlatformInfo::GetSupportsWaveOperations(Platform) != ERHIFeatureSupport::Unsupported || (IsVulkanPlatform(Platform) && IsAndroidPlatform(Platform));
+}
+
+// Selects the wave operation permutations (FArmASR_UseWaveOps, FArmASR_QuadShuffleNeighborhood) at runtime.
+inline bool ShouldUseWaveOps(const FStaticShaderPlatform Platform)
+{
+	return (FDataDrivenShaderPlatformInfo::GetSupportsWaveOperations(Platform) == ERHIFeatureSupport::RuntimeGuaranteed) ||
+		   (CanCompileWaveOps(Platform) && GRHISupportsWaveOperations);
+}
+
 // Function to setup common shader parameters. ArmASRPassParameters will be updated.
 inline void SetCommonParameters(
 	FArmASRPassParameters* ArmASRPassParameters,
@@ -179,6 +197,15 @@ inline void SetCommonParameters(
 	// fViewSpaceToMetersFactor
 	ArmASRPassParameters->fViewSpaceToMetersFactor = 1.0f;
 
+	// uReconstructedDepthEpoch, only used by the epoch tagged reconstructed previous depth.
+	ArmASRPassParameters->uReconstructedDepthEpoch = 0;
+
+	// uGroupSwizzleWidth, row-major thread group order unless r.ArmASR.GroupSwizzle is set.
+	ArmASRPassParameters->uGroupSwizzleWidth = 0;
+
+	// uJitterPhaseIndex, index of fJitter in the engine's jitter sequence.
+	ArmASRPassParameters->uJitterPhaseIndex = FMath::Max(ViewInfo.TemporalJitterIndex, 0);
+
 	// fDynamicResChangeFactor
 	ArmASRPassParameters->fDynamicResChangeFactor = 0.0;
 }
@@ -232,3 +259,12 @@ static float Lanczos2(float Value)
 	return std::abs(Value) < ARM_ASR_EPSILON ? 1.f :
 		(std::sinf(ARM_ASR_PI * Value) / (ARM_ASR_PI * Value)) * (std::sinf(0.5f * ARM_ASR_PI * Value) / (0.5f * ARM_ASR_PI * Value));
 }
+
+// Same approximation as Lanczos2ApproxSq in ffxm_fsr2_sample.h. Input is x*x.
+static float Lanczos2ApproxSq(float ValueSq)
+{
+	ValueSq = std::min(ValueSq, 4.0f);
+	const float A = (2.0f / 5.0f) * ValueSq - 1.0f;
+	const float B = (1.0f / 4.0f) * ValueSq - 1.0f;
+	return ((25.0f / 16.0f) * A * A - (25.0f / 16.0f - 1.0f)) * (B * B);
+}
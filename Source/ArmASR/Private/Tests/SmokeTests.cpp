@@ -12,6 +12,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "HAL/IConsoleManager.h"
 #include "HAL/PlatformProcess.h"
+#include "RHI.h"
 #include "Framework/Application/SlateApplication.h"
 
 #include "ArmASR.h"
@@ -56,6 +57,59 @@ private:
 	bool bHasSet;
 };
 
+// Values of console variables, saved by FSaveConsoleVariablesLatentCommand to be restored by
+// FRestoreConsoleVariablesLatentCommand once a test has changed them.
+using FSavedConsoleVariables = TMap<FString, FString>;
+
+class FSaveConsoleVariablesLatentCommand : public IAutomationLatentCommand
+{
+public:
+	FSaveConsoleVariablesLatentCommand(const TArray<FString>& InConsoleVarNames, const TSharedRef<FSavedConsoleVariables>& InSavedValues)
+		: ConsoleVarNames(InConsoleVarNames)
+		, SavedValues(InSavedValues)
+	{}
+
+	virtual bool Update() override
+	{
+		for (const FString& ConsoleVarName : ConsoleVarNames)
+		{
+			if (IConsoleVariable* ConsoleVar = IConsoleManager::Get().FindConsoleVariable(*ConsoleVarName))
+			{
+				SavedValues->Add(ConsoleVarName, ConsoleVar->GetString());
+			}
+		}
+		return true;
+	}
+
+private:
+	TArray<FString> ConsoleVarNames;
+	TSharedRef<FSavedConsoleVariables> SavedValues;
+};
+
+class FRestoreConsoleVariablesLatentCommand : public IAutomationLatentCommand
+{
+public:
+	FRestoreConsoleVariablesLatentCommand(const TSharedRef<FSavedConsoleVariables>& InSavedValues)
+		: SavedValues(InSavedValues)
+	{}
+
+	virtual bool Update() override
+	{
+		for (const TPair<FString, FString>& SavedValue : *SavedValues)
+		{
+			if (IConsoleVariable* ConsoleVar = IConsoleManager::Get().FindConsoleVariable(*SavedValue.Key))
+			{
+				ConsoleVar->Set(*SavedValue.Value, ECVF_SetByConsole);
+				UE_LOG(LogTemp, Log, TEXT("Restored console variable '%s' to %s."), *SavedValue.Key, *SavedValue.Value);
+			}
+		}
+		return true;
+	}
+
+private:
+	TSharedRef<FSavedConsoleVariables> SavedValues;
+};
+
 
 // Custom latent command to take a screenshot in game mode.
 class FTakeScreenshotLatentCommand : public IAutomationLatentCommand
@@ -97,6 +151,47 @@ private:
 	double StartTime;
 };
 
+// Latent command to log the average GPU frame time over a number of seconds, to compare settings on a device. The
+// average is also written to OutAverageMilliseconds when given.
+class FLogAverageGPUFrameTimeLatentCommand : public IAutomationLatentCommand
+{
+public:
+	FLogAverageGPUFrameTimeLatentCommand(const FString& InLabel, float InDuration, const TSharedPtr<double>& InOutAverageMilliseconds = nullptr)
+		: Label(InLabel)
+		, Duration(InDuration)
+		, TotalMilliseconds(0.0)
+		, FrameCount(0)
+		, OutAverageMilliseconds(InOutAverageMilliseconds)
+	{}
+
+	// Update() is called every frame until it returns true.
+	virtual bool Update() override
+	{
+		// The GPU time of the previous frame.
+		TotalMilliseconds += FPlatformTime::ToMilliseconds64(RHIGetGPUFrameCycles());
+		++FrameCount;
+
+		if (GetCurrentRunTime() < Duration)
+		{
+			return false;
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("%s: average GPU frame time %.3f ms over %d frames."), *Label, TotalMilliseconds / FrameCount, FrameCount);
+		if (OutAverageMilliseconds)
+		{
+			*OutAverageMilliseconds = TotalMilliseconds / FrameCount;
+		}
+		return true;
+	}
+
+private:
+	FString Label;
+	float Duration;
+	double TotalMilliseconds;
+	int32 FrameCount;
+	TSharedPtr<double> OutAverageMilliseconds;
+};
+
 
 IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArmASREnableTest,
 	"ArmASR.PluginTests.EnablePluginTest",
@@ -394,4 +489,171 @@ bool FArmASRFilmGrainTest::RunTest(const FString &Parameters)
 	return true;
 }
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArmASRLanczosReprojectionTest,
+	"ArmASR.PluginTests.LanczosReprojectionTest",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+	| EAutomationTestFlags::ServerContext | EAutomationTestFlags::CommandletContext
+	| EAutomationTestFlags::EngineFilter | EAutomationTestFlags::NonNullRHI)
+
+bool FArmASRLanczosReprojectionTest::RunTest(const FString& Parameters)
+{
+	// The reprojection filter has no shader permutations unless the project compiles the experimental ones.
+	const IConsoleVariable* ExperimentalPermutations = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ArmASR.ExperimentalShaderPermutations"));
+	if (!ExperimentalPermutations || !ExperimentalPermutations->GetInt())
+	{
+		AddWarning(TEXT("r.ArmASR.LanczosReprojection is ignored unless r.ArmASR.ExperimentalShaderPermutations is set, nothing to compare."));
+		return true;
+	}
+
+	// 1. Ensure Arm ASR is enabled with the Quality preset, the only one the option applies to, and save the values the
+	// test changes.
+	TSharedRef<FSavedConsoleVariables> SavedValues = MakeShared<FSavedConsoleVariables>();
+	ADD_LATENT_AUTOMATION_COMMAND(FSaveConsoleVariablesLatentCommand({ TEXT("r.ArmASR.LanczosReprojection"), TEXT("r.ArmASR.ShaderQuality") }, SavedValues));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.AntiAliasingMethod"), 2));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.Enable"), true));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.ShaderQuality"), 1));
+
+	// 2. Load a test map (ensure the map exists in your project)
+	const FString MapName = "/Game/_Game/ThirdPerson/ThirdPerson";
+	if (!AutomationOpenMap(MapName))
+	{
+		AddError(FString::Printf(TEXT("Failed to open map %s"), *MapName));
+		return false;
+	}
+
+	// 3. Wait for the map to load and render. Use a latent command to delay execution.
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(5.0f));
+
+	// 4. Reproject the history with the default kernel (the 16-tap Lanczos2 reference where FP16 is not supported), let it
+	// converge and take the reference screenshot.
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.LanczosReprojection"), 0));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(1.0f));
+	ADD_LATENT_AUTOMATION_COMMAND(FTakeScreenshotLatentCommand(TEXT("ArmASR_LanczosReprojectionTest_0")));
+
+	// 5. Reproject it with Lanczos2 weights in 9 bilinear fetches and take the screenshot to compare (PSNR/SSIM) against it.
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.LanczosReprojection"), 1));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(1.0f));
+	ADD_LATENT_AUTOMATION_COMMAND(FTakeScreenshotLatentCommand(TEXT("ArmASR_LanczosReprojectionTest_1")));
+
+	// 6. Restore the values from before the test.
+	ADD_LATENT_AUTOMATION_COMMAND(FRestoreConsoleVariablesLatentCommand(SavedValues));
+
+	return true;
+}
+
+// Benchmarks. Run these on the target device to choose the device profile values of the options they compare.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArmASRLanczosLutBenchmark,
+	"ArmASR.PluginTests.LanczosLutBenchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+	| EAutomationTestFlags::ServerContext | EAutomationTestFlags::CommandletContext
+	| EAutomationTestFlags::EngineFilter | EAutomationTestFlags::NonNullRHI)
+
+bool FArmASRLanczosLutBenchmark::RunTest(const FString& Parameters)
+{
+	// The lookup texture has no shader permutations unless the project compiles the experimental ones.
+	const IConsoleVariable* ExperimentalPermutations = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ArmASR.ExperimentalShaderPermutations"));
+	if (!ExperimentalPermutations || !ExperimentalPermutations->GetInt())
+	{
+		AddWarning(TEXT("r.ArmASR.LanczosLut is ignored unless r.ArmASR.ExperimentalShaderPermutations is set, nothing to compare."));
+		return true;
+	}
+
+	// 1. Ensure Arm ASR is enabled, and save the value of the option being compared.
+	TSharedRef<FSavedConsoleVariables> SavedValues = MakeShared<FSavedConsoleVariables>();
+	ADD_LATENT_AUTOMATION_COMMAND(FSaveConsoleVariablesLatentCommand({ TEXT("r.ArmASR.LanczosLut") }, SavedValues));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.AntiAliasingMethod"), 2));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.Enable"), true));
+
+	// 2. Load a test map (ensure the map exists in your project)
+	const FString MapName = "/Game/_Game/ThirdPerson/ThirdPerson";
+	if (!AutomationOpenMap(MapName))
+	{
+		AddError(FString::Printf(TEXT("Failed to open map %s"), *MapName));
+		return false;
+	}
+
+	// 3. Wait for the map to load and render. Use a latent command to delay execution.
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(5.0f));
+
+	// 4. Evaluate the Lanczos weights in ALU, let the frame time settle and measure it.
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.LanczosLut"), false));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(2.0f));
+	TSharedPtr<double> AluMilliseconds = MakeShared<double>(0.0);
+	ADD_LATENT_AUTOMATION_COMMAND(FLogAverageGPUFrameTimeLatentCommand(TEXT("r.ArmASR.LanczosLut 0"), 5.0f, AluMilliseconds));
+
+	// 5. Read the Lanczos weights from the lookup texture and measure again.
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.LanczosLut"), true));
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(2.0f));
+	TSharedPtr<double> LutMilliseconds = MakeShared<double>(0.0);
+	ADD_LATENT_AUTOMATION_COMMAND(FLogAverageGPUFrameTimeLatentCommand(TEXT("r.ArmASR.LanczosLut 1"), 5.0f, LutMilliseconds));
+
+	// 6. Report the faster setting, to use in the device profile.
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([AluMilliseconds, LutMilliseconds]()
+	{
+		UE_LOG(LogTemp, Display, TEXT("r.ArmASR.LanczosLut %d is faster on this device (%.3f ms against %.3f ms)."),
+			*LutMilliseconds < *AluMilliseconds ? 1 : 0, FMath::Min(*AluMilliseconds, *LutMilliseconds), FMath::Max(*AluMilliseconds, *LutMilliseconds));
+		return true;
+	}));
+
+	// 7. Restore the value from before the test.
+	ADD_LATENT_AUTOMATION_COMMAND(FRestoreConsoleVariablesLatentCommand(SavedValues));
+
+	return true;
+}
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FArmASRGroupSwizzleBenchmark,
+	"ArmASR.PluginTests.GroupSwizzleBenchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext
+	| EAutomationTestFlags::ServerContext | EAutomationTestFlags::CommandletContext
+	| EAutomationTestFlags::EngineFilter | EAutomationTestFlags::NonNullRHI)
+
+bool FArmASRGroupSwizzleBenchmark::RunTest(const FString& Parameters)
+{
+	// The compute passes have no shader permutations unless the project compiles the experimental ones.
+	const IConsoleVariable* ExperimentalPermutations = IConsoleManager::Get().FindConsoleVariable(TEXT("r.ArmASR.ExperimentalShaderPermutations"));
+	if (!ExperimentalPermutations || !ExperimentalPermutations->GetInt())
+	{
+		AddWarning(TEXT("r.ArmASR.GroupsharedNeighborhood is ignored unless r.ArmASR.ExperimentalShaderPermutations is set, nothing to compare."));
+		return true;
+	}
+
+	// 1. Ensure Arm ASR is enabled, with Depth Clip running as a compute shader alongside Lock. The thread group size is
+	// pinned to 8x8 so that the runs only differ in their group order. Save the values the test changes.
+	TSharedRef<FSavedConsoleVariables> SavedValues = MakeShared<FSavedConsoleVariables>();
+	ADD_LATENT_AUTOMATION_COMMAND(FSaveConsoleVariablesLatentCommand({ TEXT("r.ArmASR.GroupSwizzle"), TEXT("r.ArmASR.GroupsharedNeighborhood"), TEXT("r.ArmASR.ComputeGroupSize"), TEXT("r.ArmASR.ComputePassTimings") }, SavedValues));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.AntiAliasingMethod"), 2));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.Enable"), true));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.GroupsharedNeighborhood"), 1));
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.ComputeGroupSize"), 0));
+
+	// 2. Load a test map (ensure the map exists in your project)
+	const FString MapName = "/Game/_Game/ThirdPerson/ThirdPerson";
+	if (!AutomationOpenMap(MapName))
+	{
+		AddError(FString::Printf(TEXT("Failed to open map %s"), *MapName));
+		return false;
+	}
+
+	// 3. Wait for the map to load and render. Use a latent command to delay execution.
+	ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(5.0f));
+
+	// 4. Time the Depth Clip and Lock passes with GPU timestamps, rather than the whole frame, which Arm ASR logs as the
+	// median of each pass every 64 frames.
+	ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.ComputePassTimings"), 64));
+
+	// 5. Measure row-major thread group order, then strips of increasing width. Capture a GPU counter trace alongside
+	// to compare the texture cache hit rates of the two passes.
+	for (const int32 StripWidth : { 0, 4, 8, 16 })
+	{
+		ADD_LATENT_AUTOMATION_COMMAND(FSetConsoleVariableLatentCommand(TEXT("r.ArmASR.GroupSwizzle"), StripWidth));
+		ADD_LATENT_AUTOMATION_COMMAND(FWaitLatentCommand(5.0f));
+	}
+
+	// 6. Restore the values from before the test.
+	ADD_LATENT_AUTOMATION_COMMAND(FRestoreConsoleVariablesLatentCommand(SavedValues));
+
+	return true;
+}
+
 #endif